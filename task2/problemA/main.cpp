@@ -1,14 +1,37 @@
 #include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <queue>
 #include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 const size_t alphabet_length = 256;
+const size_t bits_in_symbol = 8;
+const size_t bits_in_word = 64;
+const size_t bits_in_rrr_block = 15;
+const size_t bits_in_rrr_class = 4;
+const size_t rrr_classes_in_word = 16;
+const size_t rrr_blocks_in_superblock = 32;
+const size_t default_sample_rate = 32;
+const size_t default_memory_budget = size_t(1) << 30;
+const size_t io_buffer_bytes = size_t(1) << 20;
+const size_t prefetch_distance = 16;
 
 using std::cin;
 using std::cout;
 using std::endl;
 using std::max;
 using std::min;
+using std::pair;
+using std::priority_queue;
+using std::sort;
 using std::string;
 using std::vector;
 
@@ -22,6 +45,7 @@ class SufArray {
  public:
   size_t operator[](const size_t index) const { return suff_arr_[index]; }
   size_t Size() const { return suff_arr_.size(); }
+  const size_t *Data() const { return suff_arr_.data(); }
   SufArray(const string &input_string);
 };
 
@@ -130,21 +154,1185 @@ vector<size_t> CountMaxLengthOfCommonPrefixes(const SufArray &suff_arr,
   return ans;
 }
 
+// Extends a common prefix of len symbols of first and second up to limit.
+size_t ExtendCommonPrefix(const char *first, const char *second, size_t len,
+                          size_t limit) {
+#ifdef __AVX2__
+  while (len + sizeof(__m256i) <= limit) {
+    __m256i a = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(first + len));
+    __m256i b = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(second + len));
+    uint32_t mismatch =
+        ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    if (mismatch != 0) {
+      return len + static_cast<size_t>(__builtin_ctz(mismatch));
+    }
+    len += sizeof(__m256i);
+  }
+#endif
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  while (len + sizeof(uint64_t) <= limit) {
+    uint64_t a;
+    uint64_t b;
+    memcpy(&a, first + len, sizeof(uint64_t));
+    memcpy(&b, second + len, sizeof(uint64_t));
+    if (a != b) {
+      return len + static_cast<size_t>(__builtin_ctzll(a ^ b)) / 8;
+    }
+    len += sizeof(uint64_t);
+  }
+#endif
+  while (len < limit && first[len] == second[len]) {
+    ++len;
+  }
+  return len;
+}
+
+size_t ExtendCommonPrefix(const string &str, size_t first, size_t second,
+                          size_t len) {
+  return ExtendCommonPrefix(str.data() + first, str.data() + second, len,
+                            str.size() - max(first, second));
+}
+
+vector<size_t> CountMaxLengthOfCommonPrefixesFast(const SufArray &suff_arr,
+                                                  const string &str) {
+  vector<size_t> ans(str.size());
+  size_t pos = 0;
+  vector<size_t> anti_suff_arr(suff_arr.Size());
+  for (size_t i = 0; i < suff_arr.Size(); ++i) {
+    anti_suff_arr[suff_arr[i]] = i;
+  }
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (i + 2 * prefetch_distance < str.size()) {
+      size_t rank = anti_suff_arr[i + 2 * prefetch_distance];
+      __builtin_prefetch(&ans[rank], 1);
+      __builtin_prefetch(suff_arr.Data() + min(rank + 1, str.size() - 1));
+    }
+    if (i + prefetch_distance < str.size()) {
+      size_t rank = anti_suff_arr[i + prefetch_distance];
+      __builtin_prefetch(&str[suff_arr[min(rank + 1, str.size() - 1)]]);
+    }
+    if (pos > 0) {
+      --pos;
+    }
+    if (anti_suff_arr[i] != str.size() - 1) {
+      pos = ExtendCommonPrefix(str, i, suff_arr[anti_suff_arr[i] + 1], pos);
+      ans[anti_suff_arr[i]] = pos;
+    } else {
+      pos = 0;
+    }
+  }
+  return ans;
+}
+
+vector<size_t> CountMaxLengthOfCommonPrefixesPhi(const SufArray &suff_arr,
+                                                 const string &str) {
+  vector<size_t> plcp(str.size());
+  for (size_t i = 0; i < suff_arr.Size(); ++i) {
+    if (i + prefetch_distance < suff_arr.Size()) {
+      __builtin_prefetch(&plcp[suff_arr[i + prefetch_distance]], 1);
+    }
+    plcp[suff_arr[i]] = i + 1 < suff_arr.Size() ? suff_arr[i + 1] : str.size();
+  }
+  size_t pos = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (i + prefetch_distance < str.size() &&
+        plcp[i + prefetch_distance] < str.size()) {
+      __builtin_prefetch(&str[plcp[i + prefetch_distance]]);
+    }
+    if (pos > 0) {
+      --pos;
+    }
+    if (plcp[i] == str.size()) {
+      pos = 0;
+    } else {
+      pos = ExtendCommonPrefix(str, i, plcp[i], pos);
+    }
+    plcp[i] = pos;
+  }
+  vector<size_t> ans(str.size());
+  for (size_t i = 0; i < suff_arr.Size(); ++i) {
+    if (i + prefetch_distance < suff_arr.Size()) {
+      __builtin_prefetch(&plcp[suff_arr[i + prefetch_distance]]);
+    }
+    ans[i] = plcp[suff_arr[i]];
+  }
+  return ans;
+}
+
+// Every suffix adds its length minus its common prefix with the neighbouring
+// suffix in sorted order, so the count only needs the sum of the LCP array.
+uint64_t CountDifferentSubstringsByLcp(uint64_t size, uint64_t sum_of_lcp) {
+  return size * (size + 1) / 2 - sum_of_lcp;
+}
+
+int CountDifferentSubstrings(const SufArray &suff_arr, const string &s) {
+  vector<size_t> lcp = CountMaxLengthOfCommonPrefixesPhi(suff_arr, s);
+  uint64_t sum_of_lcp = 0;
+  for (size_t value : lcp) {
+    sum_of_lcp += value;
+  }
+  return static_cast<int>(CountDifferentSubstringsByLcp(s.size() - 1,
+                                                        sum_of_lcp));
+}
+
 int FindCountOfDifferentSubstrings(const string &input_str) {
   string s = input_str + '$';
   SufArray suff_arr(s);
-  vector<size_t> lcp = CountMaxLengthOfCommonPrefixes(suff_arr, s);
-  int ans = 0;
-  for (size_t i = 1; i < lcp.size(); ++i) {
-    ans +=
-        static_cast<int>(s.size()) - static_cast<int>(suff_arr[i] + lcp[i]) - 1;
+  return CountDifferentSubstrings(suff_arr, s);
+}
+
+class BitVector {
+ private:
+  vector<uint64_t> words_;
+
+ public:
+  explicit BitVector(size_t size) : words_(size / bits_in_word + 1, 0) {}
+  void Set(size_t index) {
+    words_[index / bits_in_word] |= uint64_t(1) << (index % bits_in_word);
   }
-  return ans;
+  bool operator[](size_t index) const {
+    return (words_[index / bits_in_word] >> (index % bits_in_word)) & 1;
+  }
+};
+
+// Enumerative code of the blocks of an RrrBitVector: the blocks of every
+// class (number of ones) are numbered in increasing order.
+struct RrrTables {
+  uint16_t offset_of_block[size_t(1) << bits_in_rrr_block];
+  uint16_t block_of_offset[size_t(1) << bits_in_rrr_block];
+  size_t class_begin[bits_in_rrr_block + 2];
+  size_t offset_bits[bits_in_rrr_block + 1];
+
+  RrrTables();
+};
+
+RrrTables::RrrTables() : class_begin(), offset_bits() {
+  size_t blocks_count = size_t(1) << bits_in_rrr_block;
+  for (size_t block = 0; block < blocks_count; ++block) {
+    ++class_begin[static_cast<size_t>(__builtin_popcountll(block)) + 1];
+  }
+  for (size_t k = 0; k <= bits_in_rrr_block; ++k) {
+    while ((size_t(1) << offset_bits[k]) < class_begin[k + 1]) {
+      ++offset_bits[k];
+    }
+    class_begin[k + 1] += class_begin[k];
+  }
+  vector<size_t> filled(class_begin, class_begin + bits_in_rrr_block + 1);
+  for (size_t block = 0; block < blocks_count; ++block) {
+    size_t k = static_cast<size_t>(__builtin_popcountll(block));
+    offset_of_block[block] = static_cast<uint16_t>(filled[k] - class_begin[k]);
+    block_of_offset[filled[k]++] = static_cast<uint16_t>(block);
+  }
+}
+
+// Raman-Raman-Rao compressed bitvector: every block of bits_in_rrr_block
+// bits is stored as its class in 4 bits plus its offset among the blocks of
+// that class, so long runs of zeros or ones take about 4 bits per block.
+// Bits are appended in order and the vector is read-only after Finish().
+class RrrBitVector {
+ private:
+  vector<uint64_t> classes_;
+  vector<uint64_t> offsets_;
+  vector<size_t> rank_samples_;
+  vector<size_t> offset_samples_;
+  size_t size_;
+  size_t ones_;
+  size_t blocks_;
+  size_t offsets_size_;
+  uint64_t pending_;
+
+  static const RrrTables &Tables();
+  size_t BlockClass(size_t block) const {
+    return (classes_[block / rrr_classes_in_word] >>
+            (block % rrr_classes_in_word * bits_in_rrr_class)) &
+           ((size_t(1) << bits_in_rrr_class) - 1);
+  }
+  uint64_t ReadOffset(size_t pos, size_t width) const;
+  void WriteOffset(uint64_t offset, size_t width);
+  void FlushBlock();
+  uint64_t DecodeBlock(size_t ones, size_t pos) const {
+    const RrrTables &tables = Tables();
+    return tables.block_of_offset[tables.class_begin[ones] +
+                                  ReadOffset(pos, tables.offset_bits[ones])];
+  }
+  uint64_t FindBlock(size_t index, size_t &rank) const;
+  size_t FindSuperblock(size_t k, bool is_one) const;
+
+ public:
+  RrrBitVector()
+      : size_(0), ones_(0), blocks_(0), offsets_size_(0), pending_(0) {}
+  void PushBack(bool bit);
+  void Finish();
+  size_t Size() const { return size_; }
+  bool operator[](size_t index) const;
+  size_t Rank1(size_t index) const;
+  size_t Rank0(size_t index) const { return index - Rank1(index); }
+  size_t Select1(size_t k) const;
+  size_t Select0(size_t k) const;
+};
+
+const RrrTables &RrrBitVector::Tables() {
+  static const RrrTables tables;
+  return tables;
+}
+
+uint64_t RrrBitVector::ReadOffset(size_t pos, size_t width) const {
+  if (width == 0) {
+    return 0;
+  }
+  size_t word = pos / bits_in_word;
+  size_t shift = pos % bits_in_word;
+  uint64_t value = offsets_[word] >> shift;
+  if (shift + width > bits_in_word) {
+    value |= offsets_[word + 1] << (bits_in_word - shift);
+  }
+  return value & ((uint64_t(1) << width) - 1);
+}
+
+void RrrBitVector::WriteOffset(uint64_t offset, size_t width) {
+  while (offsets_.size() * bits_in_word < offsets_size_ + width) {
+    offsets_.push_back(0);
+  }
+  if (width == 0) {
+    return;
+  }
+  size_t word = offsets_size_ / bits_in_word;
+  size_t shift = offsets_size_ % bits_in_word;
+  offsets_[word] |= offset << shift;
+  if (shift + width > bits_in_word) {
+    offsets_[word + 1] |= offset >> (bits_in_word - shift);
+  }
+  offsets_size_ += width;
+}
+
+void RrrBitVector::FlushBlock() {
+  if (blocks_ % rrr_blocks_in_superblock == 0) {
+    rank_samples_.push_back(ones_);
+    offset_samples_.push_back(offsets_size_);
+  }
+  if (blocks_ % rrr_classes_in_word == 0) {
+    classes_.push_back(0);
+  }
+  size_t k = static_cast<size_t>(__builtin_popcountll(pending_));
+  classes_.back() |= static_cast<uint64_t>(k)
+                     << (blocks_ % rrr_classes_in_word * bits_in_rrr_class);
+  WriteOffset(Tables().offset_of_block[pending_], Tables().offset_bits[k]);
+  ones_ += k;
+  ++blocks_;
+  pending_ = 0;
+}
+
+void RrrBitVector::PushBack(bool bit) {
+  pending_ |= static_cast<uint64_t>(bit) << (size_ % bits_in_rrr_block);
+  ++size_;
+  if (size_ % bits_in_rrr_block == 0) {
+    FlushBlock();
+  }
+}
+
+void RrrBitVector::Finish() {
+  if (size_ % bits_in_rrr_block != 0) {
+    FlushBlock();
+  }
+}
+
+// Decodes the block holding index and counts the ones before that block.
+uint64_t RrrBitVector::FindBlock(size_t index, size_t &rank) const {
+  const RrrTables &tables = Tables();
+  size_t block = index / bits_in_rrr_block;
+  size_t superblock = block / rrr_blocks_in_superblock;
+  rank = rank_samples_[superblock];
+  size_t pos = offset_samples_[superblock];
+  for (size_t i = superblock * rrr_blocks_in_superblock; i < block; ++i) {
+    size_t k = BlockClass(i);
+    rank += k;
+    pos += tables.offset_bits[k];
+  }
+  return DecodeBlock(BlockClass(block), pos);
+}
+
+bool RrrBitVector::operator[](size_t index) const {
+  size_t rank;
+  return (FindBlock(index, rank) >> (index % bits_in_rrr_block)) & 1;
+}
+
+size_t RrrBitVector::Rank1(size_t index) const {
+  if (index >= size_) {
+    return ones_;
+  }
+  size_t rank;
+  uint64_t block = FindBlock(index, rank);
+  uint64_t mask = (uint64_t(1) << (index % bits_in_rrr_block)) - 1;
+  return rank + static_cast<size_t>(__builtin_popcountll(block & mask));
+}
+
+// The last superblock starting with at most k ones (or zeros).
+size_t RrrBitVector::FindSuperblock(size_t k, bool is_one) const {
+  size_t superblock_bits = rrr_blocks_in_superblock * bits_in_rrr_block;
+  size_t left = 0;
+  size_t right = rank_samples_.size();
+  while (right - left > 1) {
+    size_t middle = (left + right) / 2;
+    size_t count = is_one ? rank_samples_[middle]
+                          : middle * superblock_bits - rank_samples_[middle];
+    if (count <= k) {
+      left = middle;
+    } else {
+      right = middle;
+    }
+  }
+  return left;
+}
+
+size_t RrrBitVector::Select1(size_t k) const {
+  if (k >= ones_) {
+    return size_;
+  }
+  size_t superblock = FindSuperblock(k, true);
+  k -= rank_samples_[superblock];
+  size_t pos = offset_samples_[superblock];
+  for (size_t i = superblock * rrr_blocks_in_superblock;; ++i) {
+    size_t ones = BlockClass(i);
+    if (k < ones) {
+      uint64_t block = DecodeBlock(ones, pos);
+      for (; k > 0; --k) {
+        block &= block - 1;
+      }
+      return i * bits_in_rrr_block +
+             static_cast<size_t>(__builtin_ctzll(block));
+    }
+    k -= ones;
+    pos += Tables().offset_bits[ones];
+  }
+}
+
+size_t RrrBitVector::Select0(size_t k) const {
+  if (k >= size_ - ones_) {
+    return size_;
+  }
+  size_t superblock = FindSuperblock(k, false);
+  k -= superblock * rrr_blocks_in_superblock * bits_in_rrr_block -
+       rank_samples_[superblock];
+  size_t pos = offset_samples_[superblock];
+  for (size_t i = superblock * rrr_blocks_in_superblock;; ++i) {
+    size_t ones = BlockClass(i);
+    size_t zeros = bits_in_rrr_block - ones;
+    if (k < zeros) {
+      uint64_t block = ~DecodeBlock(ones, pos);
+      for (; k > 0; --k) {
+        block &= block - 1;
+      }
+      return i * bits_in_rrr_block +
+             static_cast<size_t>(__builtin_ctzll(block));
+    }
+    k -= zeros;
+    pos += Tables().offset_bits[ones];
+  }
+}
+
+// The external passes cannot go on after a failed file operation, so the
+// failure is reported and the program stops.
+void CheckIo(bool is_ok, const char *operation) {
+  if (!is_ok) {
+    perror(operation);
+    exit(EXIT_FAILURE);
+  }
+}
+
+class TempFile {
+ private:
+  FILE *file_;
+
+ public:
+  TempFile() : file_(std::tmpfile()) { CheckIo(file_ != nullptr, "tmpfile"); }
+  TempFile(const TempFile &) = delete;
+  TempFile(TempFile &&other) noexcept : file_(other.file_) {
+    other.file_ = nullptr;
+  }
+  TempFile &operator=(const TempFile &) = delete;
+  TempFile &operator=(TempFile &&other) noexcept {
+    std::swap(file_, other.file_);
+    return *this;
+  }
+  ~TempFile() {
+    if (file_ != nullptr) {
+      fclose(file_);
+    }
+  }
+  FILE *Get() const { return file_; }
+};
+
+template <typename T>
+class RecordWriter {
+ private:
+  FILE *file_;
+  vector<T> buffer_;
+
+ public:
+  explicit RecordWriter(FILE *file) : file_(file) {
+    CheckIo(fseek(file_, 0, SEEK_SET) == 0, "fseek");
+    buffer_.reserve(io_buffer_bytes / sizeof(T));
+  }
+  RecordWriter(const RecordWriter &) = delete;
+  ~RecordWriter() {
+    Flush();
+    CheckIo(fflush(file_) == 0, "fflush");
+  }
+  void Push(const T &record) {
+    buffer_.push_back(record);
+    if (buffer_.size() == buffer_.capacity()) {
+      Flush();
+    }
+  }
+  void Flush() {
+    CheckIo(fwrite(buffer_.data(), sizeof(T), buffer_.size(), file_) ==
+                buffer_.size(),
+            "fwrite");
+    buffer_.clear();
+  }
+};
+
+template <typename T>
+class RecordReader {
+ private:
+  FILE *file_;
+  vector<T> buffer_;
+  size_t pos_;
+  size_t filled_;
+  size_t offset_;
+
+ public:
+  RecordReader(FILE *file, size_t skip = 0,
+               size_t buffer_bytes = io_buffer_bytes)
+      : file_(file),
+        buffer_(max(buffer_bytes / sizeof(T), size_t(1))),
+        pos_(0),
+        filled_(0),
+        offset_(skip) {}
+  bool Next(T &record) {
+    if (pos_ == filled_) {
+      CheckIo(fseek(file_, static_cast<long>(offset_ * sizeof(T)),
+                    SEEK_SET) == 0,
+              "fseek");
+      filled_ = fread(buffer_.data(), sizeof(T), buffer_.size(), file_);
+      CheckIo(ferror(file_) == 0, "fread");
+      offset_ += filled_;
+      pos_ = 0;
+      if (filled_ == 0) {
+        return false;
+      }
+    }
+    record = buffer_[pos_++];
+    return true;
+  }
+};
+
+template <typename T, typename Compare>
+class ExternalSorter {
+ private:
+  vector<T> run_;
+  vector<TempFile> runs_;
+  size_t memory_budget_;
+  Compare less_;
+
+  void SpillRun();
+
+ public:
+  explicit ExternalSorter(size_t memory_budget, Compare less = Compare())
+      : memory_budget_(memory_budget), less_(less) {
+    run_.reserve(max(memory_budget / sizeof(T) / 2, size_t(1)));
+  }
+  void Push(const T &record) {
+    run_.push_back(record);
+    if (run_.size() == run_.capacity()) {
+      SpillRun();
+    }
+  }
+  TempFile Sort();
+};
+
+template <typename T, typename Compare>
+void ExternalSorter<T, Compare>::SpillRun() {
+  sort(run_.begin(), run_.end(), less_);
+  runs_.emplace_back();
+  RecordWriter<T> writer(runs_.back().Get());
+  for (const T &record : run_) {
+    writer.Push(record);
+  }
+  run_.clear();
+}
+
+template <typename T, typename Compare>
+TempFile ExternalSorter<T, Compare>::Sort() {
+  if (!run_.empty()) {
+    SpillRun();
+  }
+  vector<T>().swap(run_);
+  if (runs_.empty()) {
+    return TempFile();
+  }
+  if (runs_.size() == 1) {
+    TempFile result = std::move(runs_[0]);
+    runs_.clear();
+    return result;
+  }
+  TempFile result;
+  {
+    RecordWriter<T> writer(result.Get());
+    vector<RecordReader<T>> readers;
+    size_t buffer_bytes = min(memory_budget_ / runs_.size(), io_buffer_bytes);
+    for (const TempFile &run : runs_) {
+      readers.emplace_back(run.Get(), 0, buffer_bytes);
+    }
+    auto greater = [this](const pair<T, size_t> &a, const pair<T, size_t> &b) {
+      return less_(b.first, a.first);
+    };
+    priority_queue<pair<T, size_t>, vector<pair<T, size_t>>, decltype(greater)>
+        heads(greater);
+    T record;
+    for (size_t i = 0; i < readers.size(); ++i) {
+      if (readers[i].Next(record)) {
+        heads.emplace(record, i);
+      }
+    }
+    while (!heads.empty()) {
+      pair<T, size_t> head = heads.top();
+      heads.pop();
+      writer.Push(head.first);
+      if (readers[head.second].Next(record)) {
+        heads.emplace(record, head.second);
+      }
+    }
+  }
+  runs_.clear();
+  return result;
 }
 
-int main() {
+struct RankedPosition {
+  uint64_t pos_;
+  uint64_t rank_;
+};
+
+struct RankPair {
+  uint64_t rank1_;
+  uint64_t rank2_;
+  uint64_t pos_;
+};
+
+// Phi of a suffix: the suffix after it in sorted order, or the text size for
+// the last one, and whether the two start with the same symbol.
+struct PhiPair {
+  uint64_t pos_;
+  uint64_t phi_;
+  bool shares_first_;
+};
+
+// A common prefix of text[first_ - matched_, ...) and
+// text[second_ - matched_, ...) being extended, and the number of reducible
+// positions that follow the first suffix in text order.
+struct LcpComparison {
+  uint64_t first_;
+  uint64_t second_;
+  uint64_t matched_;
+  uint64_t run_;
+};
+
+struct PositionedSymbol {
+  uint64_t pos_;
+  unsigned char symbol_;
+  uint64_t rank_;
+};
+
+struct LessByPos {
+  template <typename T>
+  bool operator()(const T &a, const T &b) const {
+    return a.pos_ < b.pos_;
+  }
+};
+
+struct LessByRanks {
+  bool operator()(const RankPair &a, const RankPair &b) const {
+    return a.rank1_ < b.rank1_ || (a.rank1_ == b.rank1_ && a.rank2_ < b.rank2_);
+  }
+};
+
+// Orders comparisons by the text blocks they read next, so that a block pair
+// is loaded once per round.
+struct LessByBlocks {
+  uint64_t block_;
+  bool operator()(const LcpComparison &a, const LcpComparison &b) const {
+    uint64_t a_first = a.first_ / block_;
+    uint64_t b_first = b.first_ / block_;
+    return a_first < b_first ||
+           (a_first == b_first && a.second_ / block_ < b.second_ / block_);
+  }
+};
+
+// Holds text[index * size, (index + 1) * size) of a text file, reading it only
+// when another block is asked for.
+class TextBlock {
+ private:
+  FILE *text_;
+  size_t size_;
+  size_t index_;
+  vector<char> data_;
+
+ public:
+  TextBlock(FILE *text, size_t size)
+      : text_(text), size_(size), index_(SIZE_MAX) {}
+  const char *Load(size_t index) {
+    if (index != index_) {
+      index_ = index;
+      data_.resize(size_);
+      CheckIo(fseek(text_, static_cast<long>(index * size_), SEEK_SET) == 0,
+              "fseek");
+      data_.resize(fread(data_.data(), 1, size_, text_));
+      CheckIo(ferror(text_) == 0, "fread");
+    }
+    return data_.data();
+  }
+};
+
+class ExternalSufArray {
+ private:
+  TempFile suff_arr_file_;
+  // symbol_ends_[c] is the number of suffixes starting with a symbol up to c.
+  vector<uint64_t> symbol_ends_;
+  size_t size_;
+  size_t memory_budget_;
+
+ public:
+  ExternalSufArray(FILE *text, size_t memory_budget = default_memory_budget);
+  size_t Size() const { return size_; }
+  RecordReader<uint64_t> Reader() const {
+    return RecordReader<uint64_t>(suff_arr_file_.Get());
+  }
+  uint64_t SumOfLcp(FILE *text) const;
+};
+
+ExternalSufArray::ExternalSufArray(FILE *text, size_t memory_budget)
+    : symbol_ends_(alphabet_length, 0),
+      size_(0),
+      memory_budget_(memory_budget) {
+  // names ranks text[pos, pos + curr_len) for every pos in text order.
+  TempFile names;
+  {
+    RecordWriter<RankedPosition> writer(names.Get());
+    CheckIo(fseek(text, 0, SEEK_SET) == 0, "fseek");
+    int c;
+    while ((c = fgetc(text)) != EOF) {
+      ++symbol_ends_[static_cast<size_t>(c)];
+      writer.Push({size_++, static_cast<uint64_t>(c) + 1});
+    }
+    CheckIo(ferror(text) == 0, "fgetc");
+  }
+  for (size_t c = 1; c < alphabet_length; ++c) {
+    symbol_ends_[c] += symbol_ends_[c - 1];
+  }
+  for (size_t curr_len = 1; size_ > 0; curr_len <<= 1) {
+    ExternalSorter<RankPair, LessByRanks> by_ranks(memory_budget);
+    RecordReader<RankedPosition> first(names.Get());
+    RecordReader<RankedPosition> second(names.Get(), curr_len);
+    RankedPosition a;
+    RankedPosition b;
+    while (first.Next(a)) {
+      uint64_t rank2 = second.Next(b) ? b.rank_ : 0;
+      by_ranks.Push({a.rank_, rank2, a.pos_});
+    }
+    TempFile sorted = by_ranks.Sort();
+
+    ExternalSorter<RankedPosition, LessByPos> by_pos(memory_budget);
+    RecordReader<RankPair> reader(sorted.Get());
+    RankPair prev = {0, 0, 0};
+    RankPair curr;
+    uint64_t num_of_class = 0;
+    while (reader.Next(curr)) {
+      if (num_of_class == 0 || LessByRanks()(prev, curr)) {
+        ++num_of_class;
+      }
+      by_pos.Push({curr.pos_, num_of_class});
+      prev = curr;
+    }
+    if (num_of_class == size_) {
+      RecordWriter<uint64_t> writer(suff_arr_file_.Get());
+      RecordReader<RankPair> order(sorted.Get());
+      while (order.Next(curr)) {
+        writer.Push(curr.pos_);
+      }
+      break;
+    }
+    names = by_pos.Sort();
+  }
+}
+
+// Kärkkäinen, Manzini and Puglisi's Phi algorithm out of core. Sorting the
+// pairs (SA[k], SA[k + 1]) by position gives Phi in text order. Position i is
+// reducible when Phi[i] = Phi[i - 1] + 1 and PLCP[i - 1] > 0, and then
+// PLCP[i] = PLCP[i - 1] - 1; PLCP[i - 1] > 0 is read off the symbol buckets
+// of the ranks. The irreducible values, which sum to O(n log n), are found by
+// direct comparison: every round sorts the open comparisons by the pair of
+// text blocks they read next and extends them within those blocks, so only
+// O(n) words go to disk and the text is read a block pair at a time.
+uint64_t ExternalSufArray::SumOfLcp(FILE *text) const {
+  ExternalSorter<PhiPair, LessByPos> by_pos(memory_budget_);
+  {
+    RecordReader<uint64_t> reader = Reader();
+    uint64_t rank = 0;
+    size_t symbol = 0;
+    uint64_t curr;
+    if (reader.Next(curr)) {
+      uint64_t next;
+      for (; reader.Next(next); curr = next) {
+        while (symbol_ends_[symbol] <= rank) {
+          ++symbol;
+        }
+        ++rank;
+        by_pos.Push({curr, next, rank < symbol_ends_[symbol]});
+      }
+      by_pos.Push({curr, size_, false});
+    }
+  }
+  uint64_t block = max(memory_budget_ / 4, size_t(1));
+  ExternalSorter<LcpComparison, LessByBlocks> comparisons(memory_budget_ / 2,
+                                                          {block});
+  {
+    TempFile phi = by_pos.Sort();
+    RecordReader<PhiPair> reader(phi.Get());
+    PhiPair prev = {0, size_, false};
+    PhiPair curr;
+    LcpComparison open = {0, size_, 0, 0};
+    while (reader.Next(curr)) {
+      if (curr.phi_ < size_ && curr.phi_ == prev.phi_ + 1 &&
+          prev.shares_first_) {
+        ++open.run_;
+      } else {
+        if (open.second_ < size_) {
+          comparisons.Push(open);
+        }
+        open = {curr.pos_, curr.phi_, 0, 0};
+      }
+      prev = curr;
+    }
+    if (open.second_ < size_) {
+      comparisons.Push(open);
+    }
+  }
+  uint64_t sum_of_lcp = 0;
+  TempFile pending = comparisons.Sort();
+  TextBlock first_block(text, block);
+  TextBlock second_block(text, block);
+  for (bool is_open = true; is_open;) {
+    is_open = false;
+    ExternalSorter<LcpComparison, LessByBlocks> next_round(memory_budget_ / 2,
+                                                           {block});
+    RecordReader<LcpComparison> reader(pending.Get());
+    LcpComparison comparison;
+    while (reader.Next(comparison)) {
+      uint64_t first_index = comparison.first_ / block;
+      uint64_t second_index = comparison.second_ / block;
+      const char *first = first_block.Load(first_index);
+      const char *second = first_index == second_index
+                               ? first
+                               : second_block.Load(second_index);
+      uint64_t limit = min(min((first_index + 1) * block, size_) -
+                               comparison.first_,
+                           min((second_index + 1) * block, size_) -
+                               comparison.second_);
+      uint64_t len = ExtendCommonPrefix(
+          first + comparison.first_ % block,
+          second + comparison.second_ % block, 0, limit);
+      comparison.first_ += len;
+      comparison.second_ += len;
+      comparison.matched_ += len;
+      if (len == limit && comparison.first_ < size_ &&
+          comparison.second_ < size_) {
+        next_round.Push(comparison);
+        is_open = true;
+      } else {
+        uint64_t lcp = comparison.matched_;
+        uint64_t run = comparison.run_;
+        sum_of_lcp += (run + 1) * lcp - run * (run + 1) / 2;
+      }
+    }
+    if (is_open) {
+      pending = next_round.Sort();
+    }
+  }
+  return sum_of_lcp;
+}
+
+uint64_t CountDifferentSubstringsExternal(
+    FILE *text, size_t memory_budget = default_memory_budget) {
+  ExternalSufArray suff_arr(text, memory_budget);
+  return CountDifferentSubstringsByLcp(suff_arr.Size(),
+                                       suff_arr.SumOfLcp(text));
+}
+
+// Copies the first whitespace separated word of input into a temporary file,
+// so that the external passes never hold the text in memory.
+TempFile ReadWordToFile(FILE *input) {
+  TempFile text;
+  {
+    RecordWriter<char> writer(text.Get());
+    int c = fgetc(input);
+    while (c != EOF && isspace(c)) {
+      c = fgetc(input);
+    }
+    for (; c != EOF && !isspace(c); c = fgetc(input)) {
+      writer.Push(static_cast<char>(c));
+    }
+  }
+  CheckIo(ferror(input) == 0, "fgetc");
+  return text;
+}
+
+class WaveletMatrix {
+ private:
+  vector<RrrBitVector> levels_;
+  vector<size_t> zeros_;
+  vector<size_t> symbol_begins_;
+  size_t size_;
+
+  size_t SymbolBegin(unsigned char c) const;
+  template <typename Visitor>
+  void VisitSymbols(size_t level, size_t symbol, size_t begin, size_t end,
+                    Visitor &visit) const;
+
+ public:
+  WaveletMatrix() : size_(0) {}
+  explicit WaveletMatrix(FILE *sequence);
+  size_t Size() const { return size_; }
+  unsigned char Access(size_t index) const;
+  size_t Rank(unsigned char c, size_t index) const;
+  size_t Select(unsigned char c, size_t k) const;
+  // Calls visit(c, Rank(c, begin), Rank(c, end)) for every symbol c that
+  // occurs in [begin, end), in increasing order of c.
+  template <typename Visitor>
+  void ForEachSymbol(size_t begin, size_t end, Visitor visit) const {
+    VisitSymbols(0, 0, begin, end, visit);
+  }
+};
+
+// Builds one level at a time from a file of symbols. The arrangement of the
+// next level is written to two temporary files, symbols with the current bit
+// 0 and with bit 1, so only the compressed levels stay in memory.
+WaveletMatrix::WaveletMatrix(FILE *sequence)
+    : zeros_(bits_in_symbol, 0), symbol_begins_(alphabet_length, 0),
+      size_(0) {
+  TempFile zeros;
+  TempFile ones;
+  for (size_t level = 0; level < bits_in_symbol; ++level) {
+    size_t shift = bits_in_symbol - 1 - level;
+    bool is_last = level + 1 == bits_in_symbol;
+    TempFile next_zeros;
+    TempFile next_ones;
+    RrrBitVector bits;
+    {
+      RecordWriter<unsigned char> zero_writer(next_zeros.Get());
+      RecordWriter<unsigned char> one_writer(next_ones.Get());
+      auto split = [&](FILE *part) {
+        RecordReader<unsigned char> reader(part);
+        unsigned char c;
+        while (reader.Next(c)) {
+          bool bit = (c >> shift) & 1;
+          bits.PushBack(bit);
+          if (!is_last) {
+            (bit ? one_writer : zero_writer).Push(c);
+          }
+        }
+      };
+      if (level == 0) {
+        split(sequence);
+      } else {
+        split(zeros.Get());
+        split(ones.Get());
+      }
+    }
+    bits.Finish();
+    size_ = bits.Size();
+    zeros_[level] = bits.Rank0(size_);
+    levels_.push_back(std::move(bits));
+    zeros = std::move(next_zeros);
+    ones = std::move(next_ones);
+  }
+  for (size_t c = 0; c < alphabet_length; ++c) {
+    symbol_begins_[c] = SymbolBegin(static_cast<unsigned char>(c));
+  }
+}
+
+template <typename Visitor>
+void WaveletMatrix::VisitSymbols(size_t level, size_t symbol, size_t begin,
+                                 size_t end, Visitor &visit) const {
+  if (level == bits_in_symbol) {
+    visit(static_cast<unsigned char>(symbol), begin - symbol_begins_[symbol],
+          end - symbol_begins_[symbol]);
+    return;
+  }
+  size_t zeros_begin = levels_[level].Rank0(begin);
+  size_t zeros_end = levels_[level].Rank0(end);
+  if (zeros_begin < zeros_end) {
+    VisitSymbols(level + 1, symbol << 1, zeros_begin, zeros_end, visit);
+  }
+  if (end - begin > zeros_end - zeros_begin) {
+    VisitSymbols(level + 1, symbol << 1 | 1,
+                 zeros_[level] + begin - zeros_begin,
+                 zeros_[level] + end - zeros_end, visit);
+  }
+}
+unsigned char WaveletMatrix::Access(size_t index) const {
+  unsigned char c = 0;
+  for (size_t level = 0; level < bits_in_symbol; ++level) {
+    c = static_cast<unsigned char>(c << 1);
+    if (levels_[level][index]) {
+      c |= 1;
+      index = zeros_[level] + levels_[level].Rank1(index);
+    } else {
+      index = levels_[level].Rank0(index);
+    }
+  }
+  return c;
+}
+
+size_t WaveletMatrix::SymbolBegin(unsigned char c) const {
+  size_t begin = 0;
+  for (size_t level = 0; level < bits_in_symbol; ++level) {
+    if ((c >> (bits_in_symbol - 1 - level)) & 1) {
+      begin = zeros_[level] + levels_[level].Rank1(begin);
+    } else {
+      begin = levels_[level].Rank0(begin);
+    }
+  }
+  return begin;
+}
+
+size_t WaveletMatrix::Rank(unsigned char c, size_t index) const {
+  size_t begin = 0;
+  for (size_t level = 0; level < bits_in_symbol; ++level) {
+    if ((c >> (bits_in_symbol - 1 - level)) & 1) {
+      begin = zeros_[level] + levels_[level].Rank1(begin);
+      index = zeros_[level] + levels_[level].Rank1(index);
+    } else {
+      begin = levels_[level].Rank0(begin);
+      index = levels_[level].Rank0(index);
+    }
+  }
+  return index - begin;
+}
+
+size_t WaveletMatrix::Select(unsigned char c, size_t k) const {
+  if (Rank(c, size_) <= k) {
+    return size_;
+  }
+  size_t pos = SymbolBegin(c) + k;
+  for (size_t level = bits_in_symbol; level > 0; --level) {
+    if ((c >> (bits_in_symbol - level)) & 1) {
+      pos = levels_[level - 1].Select1(pos - zeros_[level - 1]);
+    } else {
+      pos = levels_[level - 1].Select0(pos);
+    }
+  }
+  return pos;
+}
+
+class FmIndex {
+ private:
+  WaveletMatrix bwt_;
+  vector<size_t> first_positions_;
+  RrrBitVector is_sampled_;
+  vector<size_t> sampled_suff_arr_;
+  size_t size_;
+
+  size_t LastToFirst(size_t index) const;
+  size_t SuffixAt(size_t index) const;
+
+ public:
+  // Indexes the text of the file followed by the sentinel '$', which has to
+  // be smaller than every symbol of the text.
+  explicit FmIndex(FILE *text, size_t sample_rate = default_sample_rate,
+                   size_t memory_budget = default_memory_budget);
+  size_t Size() const { return size_; }
+  size_t Count(const string &pattern) const;
+  vector<size_t> Locate(const string &pattern) const;
+  uint64_t CountDifferentSubstrings() const;
+};
+
+// The suffix array comes from ExternalSufArray. Every BWT symbol precedes its
+// suffix in the text, so the (position - 1, rank) pairs are sorted by
+// position, merged with one scan of the text and sorted back by rank.
+FmIndex::FmIndex(FILE *text, size_t sample_rate, size_t memory_budget)
+    : first_positions_(alphabet_length + 1, 0), size_(0) {
+  ExternalSufArray suff_arr(text, memory_budget);
+  size_ = suff_arr.Size() + 1;
+  ExternalSorter<PositionedSymbol, LessByPos> by_pos(memory_budget);
+  {
+    auto add = [&](uint64_t rank, uint64_t pos) {
+      is_sampled_.PushBack(pos % sample_rate == 0);
+      if (pos % sample_rate == 0) {
+        sampled_suff_arr_.push_back(pos);
+      }
+      by_pos.Push({(pos + size_ - 1) % size_, 0, rank});
+    };
+    add(0, size_ - 1);
+    RecordReader<uint64_t> reader = suff_arr.Reader();
+    uint64_t rank = 1;
+    uint64_t pos;
+    while (reader.Next(pos)) {
+      add(rank++, pos);
+    }
+  }
+  is_sampled_.Finish();
+  TempFile preceding = by_pos.Sort();
+  ExternalSorter<PositionedSymbol, LessByPos> by_rank(memory_budget);
+  {
+    CheckIo(fseek(text, 0, SEEK_SET) == 0, "fseek");
+    RecordReader<PositionedSymbol> reader(preceding.Get());
+    PositionedSymbol record;
+    while (reader.Next(record)) {
+      int c = record.pos_ + 1 < size_ ? fgetc(text) : '$';
+      CheckIo(c != EOF, "fgetc");
+      unsigned char symbol = static_cast<unsigned char>(c);
+      ++first_positions_[symbol + 1];
+      by_rank.Push({record.rank_, symbol, 0});
+    }
+  }
+  for (size_t i = 1; i < first_positions_.size(); ++i) {
+    first_positions_[i] += first_positions_[i - 1];
+  }
+  TempFile bwt;
+  {
+    TempFile sorted = by_rank.Sort();
+    RecordReader<PositionedSymbol> reader(sorted.Get());
+    RecordWriter<unsigned char> writer(bwt.Get());
+    PositionedSymbol record;
+    while (reader.Next(record)) {
+      writer.Push(record.symbol_);
+    }
+  }
+  bwt_ = WaveletMatrix(bwt.Get());
+}
+size_t FmIndex::LastToFirst(size_t index) const {
+  unsigned char c = bwt_.Access(index);
+  return first_positions_[c] + bwt_.Rank(c, index);
+}
+
+size_t FmIndex::SuffixAt(size_t index) const {
+  size_t steps = 0;
+  while (!is_sampled_[index]) {
+    index = LastToFirst(index);
+    ++steps;
+  }
+  return (sampled_suff_arr_[is_sampled_.Rank1(index)] + steps) % size_;
+}
+
+size_t FmIndex::Count(const string &pattern) const {
+  size_t begin = 0;
+  size_t end = size_;
+  for (size_t i = pattern.size(); i > 0 && begin < end; --i) {
+    unsigned char c = static_cast<unsigned char>(pattern[i - 1]);
+    begin = first_positions_[c] + bwt_.Rank(c, begin);
+    end = first_positions_[c] + bwt_.Rank(c, end);
+  }
+  return begin < end ? end - begin : 0;
+}
+
+vector<size_t> FmIndex::Locate(const string &pattern) const {
+  size_t begin = 0;
+  size_t end = size_;
+  for (size_t i = pattern.size(); i > 0 && begin < end; --i) {
+    unsigned char c = static_cast<unsigned char>(pattern[i - 1]);
+    begin = first_positions_[c] + bwt_.Rank(c, begin);
+    end = first_positions_[c] + bwt_.Rank(c, end);
+  }
+  vector<size_t> positions;
+  for (size_t i = begin; i < end; ++i) {
+    positions.push_back(SuffixAt(i));
+  }
+  sort(positions.begin(), positions.end());
+  return positions;
+}
+
+// Beller, Gog, Ohlebusch and Schnattinger: the intervals of all substrings
+// are visited by backward extension in order of length. The boundary between
+// two adjacent suffixes first ends an interval at the length of their common
+// prefix plus one, and each boundary lets only one interval through, so the
+// walk takes O(n log sigma) rank queries.
+uint64_t FmIndex::CountDifferentSubstrings() const {
+  BitVector is_known(size_ + 1);
+  is_known.Set(size_);
+  uint64_t sum_of_lcp = 0;
+  vector<pair<size_t, size_t>> current = {{0, size_}};
+  vector<pair<size_t, size_t>> next;
+  for (uint64_t length = 0; !current.empty(); ++length) {
+    next.clear();
+    for (const pair<size_t, size_t> &interval : current) {
+      bwt_.ForEachSymbol(
+          interval.first, interval.second,
+          [&](unsigned char c, size_t rank_begin, size_t rank_end) {
+            size_t end = first_positions_[c] + rank_end;
+            if (!is_known[end]) {
+              is_known.Set(end);
+              sum_of_lcp += length;
+              next.emplace_back(first_positions_[c] + rank_begin, end);
+            }
+          });
+    }
+    current.swap(next);
+  }
+  return CountDifferentSubstringsByLcp(size_ - 1, sum_of_lcp);
+}
+
+#ifdef LCP_BENCHMARK
+void BenchmarkLcp(const string &input_str) {
+  string s = input_str + '$';
+  SufArray suff_arr(s);
+  vector<vector<size_t> (*)(const SufArray &, const string &)> builders = {
+      CountMaxLengthOfCommonPrefixes, CountMaxLengthOfCommonPrefixesFast,
+      CountMaxLengthOfCommonPrefixesPhi};
+  vector<string> names = {"kasai", "kasai-wordwise-prefetch", "phi-plcp"};
+  vector<size_t> expected;
+  for (size_t i = 0; i < builders.size(); ++i) {
+    auto start = std::chrono::steady_clock::now();
+    vector<size_t> lcp = builders[i](suff_arr, s);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (i == 0) {
+      expected = lcp;
+    }
+    cout << names[i] << ": " << elapsed.count() << " s"
+         << (lcp == expected ? "" : " (MISMATCH)") << endl;
+  }
+}
+#endif
+
+int main(int argc, char **argv) {
+  bool is_external = false;
+  bool use_fm_index = false;
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg == "--external") {
+      is_external = true;
+    } else if (arg == "--fm-index") {
+      use_fm_index = true;
+    }
+  }
+  if (use_fm_index) {
+    TempFile text = ReadWordToFile(stdin);
+    cout << FmIndex(text.Get()).CountDifferentSubstrings() << endl;
+    return 0;
+  }
+  if (is_external) {
+    TempFile text = ReadWordToFile(stdin);
+    cout << CountDifferentSubstringsExternal(text.Get()) << endl;
+    return 0;
+  }
   string s;
   cin >> s;
+#ifdef LCP_BENCHMARK
+  BenchmarkLcp(s);
+  return 0;
+#endif
   cout << FindCountOfDifferentSubstrings(s) << endl;
   return 0;
 }
@@ -0,0 +1,263 @@
+#ifndef TASK3_PREDICATES_H_
+#define TASK3_PREDICATES_H_
+
+#include <cmath>
+#include <vector>
+
+const double predicates_epsilon = 1.1102230246251565e-16;
+const double ccw_error_bound =
+    (3.0 + 16.0 * predicates_epsilon) * predicates_epsilon;
+const double orient3d_error_bound =
+    (7.0 + 56.0 * predicates_epsilon) * predicates_epsilon;
+const double incircle_error_bound =
+    (10.0 + 96.0 * predicates_epsilon) * predicates_epsilon;
+
+using Expansion = std::vector<double>;
+
+inline void TwoSum(double a, double b, double &sum, double &err) {
+  sum = a + b;
+  double b_virtual = sum - a;
+  double a_virtual = sum - b_virtual;
+  err = (a - a_virtual) + (b - b_virtual);
+}
+
+inline void TwoProduct(double a, double b, double &product, double &err) {
+  product = a * b;
+  err = std::fma(a, b, -product);
+}
+
+inline Expansion ExactDifference(double a, double b) {
+  double sum;
+  double err;
+  TwoSum(a, -b, sum, err);
+  if (err == 0) {
+    return {sum};
+  }
+  return {err, sum};
+}
+
+inline Expansion GrowExpansion(const Expansion &e, double b) {
+  Expansion result;
+  double q = b;
+  for (double component : e) {
+    double err;
+    TwoSum(q, component, q, err);
+    if (err != 0) {
+      result.push_back(err);
+    }
+  }
+  if (q != 0 || result.empty()) {
+    result.push_back(q);
+  }
+  return result;
+}
+
+inline Expansion ExpansionSum(const Expansion &e, const Expansion &f) {
+  Expansion result = e;
+  for (double component : f) {
+    result = GrowExpansion(result, component);
+  }
+  return result;
+}
+
+inline Expansion ScaleExpansion(const Expansion &e, double b) {
+  Expansion result;
+  double q = 0;
+  for (double component : e) {
+    double product;
+    double product_err;
+    double sum;
+    double err;
+    TwoProduct(component, b, product, product_err);
+    TwoSum(q, product_err, sum, err);
+    if (err != 0) {
+      result.push_back(err);
+    }
+    TwoSum(product, sum, q, err);
+    if (err != 0) {
+      result.push_back(err);
+    }
+  }
+  if (q != 0 || result.empty()) {
+    result.push_back(q);
+  }
+  return result;
+}
+
+inline Expansion ExpansionProduct(const Expansion &e, const Expansion &f) {
+  Expansion result = {0};
+  for (double component : f) {
+    result = ExpansionSum(result, ScaleExpansion(e, component));
+  }
+  return result;
+}
+
+inline Expansion NegateExpansion(Expansion e) {
+  for (double &component : e) {
+    component = -component;
+  }
+  return e;
+}
+
+inline double ExpansionEstimate(const Expansion &e) {
+  for (size_t i = e.size(); i > 0; --i) {
+    if (e[i - 1] != 0) {
+      return e[i - 1];
+    }
+  }
+  return 0;
+}
+
+inline Expansion CrossExpansion(const Expansion &ax, const Expansion &ay,
+                                const Expansion &bx, const Expansion &by) {
+  return ExpansionSum(ExpansionProduct(ax, by),
+                      NegateExpansion(ExpansionProduct(ay, bx)));
+}
+
+inline double Orient2dExact(double ax, double ay, double bx, double by,
+                            double cx, double cy) {
+  return ExpansionEstimate(
+      CrossExpansion(ExactDifference(ax, cx), ExactDifference(ay, cy),
+                     ExactDifference(bx, cx), ExactDifference(by, cy)));
+}
+
+// Positive if a, b, c go counterclockwise, negative if clockwise, zero if
+// collinear. The sign is exact.
+inline double Orient2d(double ax, double ay, double bx, double by, double cx,
+                       double cy) {
+  double det_left = (ax - cx) * (by - cy);
+  double det_right = (ay - cy) * (bx - cx);
+  double det = det_left - det_right;
+  double det_sum;
+  if (det_left > 0) {
+    if (det_right <= 0) {
+      return det;
+    }
+    det_sum = det_left + det_right;
+  } else if (det_left < 0) {
+    if (det_right >= 0) {
+      return det;
+    }
+    det_sum = -det_left - det_right;
+  } else {
+    return det;
+  }
+  double err_bound = ccw_error_bound * det_sum;
+  if (det >= err_bound || -det >= err_bound) {
+    return det;
+  }
+  return Orient2dExact(ax, ay, bx, by, cx, cy);
+}
+
+inline double Orient3dExact(double ax, double ay, double az, double bx,
+                            double by, double bz, double cx, double cy,
+                            double cz, double dx, double dy, double dz) {
+  Expansion adx = ExactDifference(ax, dx);
+  Expansion ady = ExactDifference(ay, dy);
+  Expansion adz = ExactDifference(az, dz);
+  Expansion bdx = ExactDifference(bx, dx);
+  Expansion bdy = ExactDifference(by, dy);
+  Expansion bdz = ExactDifference(bz, dz);
+  Expansion cdx = ExactDifference(cx, dx);
+  Expansion cdy = ExactDifference(cy, dy);
+  Expansion cdz = ExactDifference(cz, dz);
+  Expansion det =
+      ExpansionSum(ExpansionProduct(adz, CrossExpansion(bdx, bdy, cdx, cdy)),
+                   ExpansionProduct(bdz, CrossExpansion(cdx, cdy, adx, ady)));
+  det = ExpansionSum(det,
+                     ExpansionProduct(cdz, CrossExpansion(adx, ady, bdx, bdy)));
+  return ExpansionEstimate(det);
+}
+
+// Positive if d lies below the plane through a, b, c, where a, b, c appear
+// counterclockwise when viewed from above the plane. The sign is exact.
+inline double Orient3d(double ax, double ay, double az, double bx, double by,
+                       double bz, double cx, double cy, double cz, double dx,
+                       double dy, double dz) {
+  double adx = ax - dx;
+  double bdx = bx - dx;
+  double cdx = cx - dx;
+  double ady = ay - dy;
+  double bdy = by - dy;
+  double cdy = cy - dy;
+  double adz = az - dz;
+  double bdz = bz - dz;
+  double cdz = cz - dz;
+  double bdx_cdy = bdx * cdy;
+  double cdx_bdy = cdx * bdy;
+  double cdx_ady = cdx * ady;
+  double adx_cdy = adx * cdy;
+  double adx_bdy = adx * bdy;
+  double bdx_ady = bdx * ady;
+  double det = adz * (bdx_cdy - cdx_bdy) + bdz * (cdx_ady - adx_cdy) +
+               cdz * (adx_bdy - bdx_ady);
+  double permanent =
+      (std::fabs(bdx_cdy) + std::fabs(cdx_bdy)) * std::fabs(adz) +
+      (std::fabs(cdx_ady) + std::fabs(adx_cdy)) * std::fabs(bdz) +
+      (std::fabs(adx_bdy) + std::fabs(bdx_ady)) * std::fabs(cdz);
+  double err_bound = orient3d_error_bound * permanent;
+  if (det > err_bound || -det > err_bound) {
+    return det;
+  }
+  return Orient3dExact(ax, ay, az, bx, by, bz, cx, cy, cz, dx, dy, dz);
+}
+
+inline double InCircleExact(double ax, double ay, double bx, double by,
+                            double cx, double cy, double dx, double dy) {
+  Expansion adx = ExactDifference(ax, dx);
+  Expansion ady = ExactDifference(ay, dy);
+  Expansion bdx = ExactDifference(bx, dx);
+  Expansion bdy = ExactDifference(by, dy);
+  Expansion cdx = ExactDifference(cx, dx);
+  Expansion cdy = ExactDifference(cy, dy);
+  Expansion a_lift =
+      ExpansionSum(ExpansionProduct(adx, adx), ExpansionProduct(ady, ady));
+  Expansion b_lift =
+      ExpansionSum(ExpansionProduct(bdx, bdx), ExpansionProduct(bdy, bdy));
+  Expansion c_lift =
+      ExpansionSum(ExpansionProduct(cdx, cdx), ExpansionProduct(cdy, cdy));
+  Expansion det =
+      ExpansionSum(ExpansionProduct(a_lift, CrossExpansion(bdx, bdy, cdx, cdy)),
+                   ExpansionProduct(b_lift, CrossExpansion(cdx, cdy, adx, ady)));
+  det = ExpansionSum(
+      det, ExpansionProduct(c_lift, CrossExpansion(adx, ady, bdx, bdy)));
+  return ExpansionEstimate(det);
+}
+
+// Positive if d lies inside the circle through a, b, c (given
+// counterclockwise), negative if outside, zero if cocircular. The sign is
+// exact.
+inline double InCircle(double ax, double ay, double bx, double by, double cx,
+                       double cy, double dx, double dy) {
+  double adx = ax - dx;
+  double bdx = bx - dx;
+  double cdx = cx - dx;
+  double ady = ay - dy;
+  double bdy = by - dy;
+  double cdy = cy - dy;
+  double bdx_cdy = bdx * cdy;
+  double cdx_bdy = cdx * bdy;
+  double cdx_ady = cdx * ady;
+  double adx_cdy = adx * cdy;
+  double adx_bdy = adx * bdy;
+  double bdx_ady = bdx * ady;
+  double a_lift = adx * adx + ady * ady;
+  double b_lift = bdx * bdx + bdy * bdy;
+  double c_lift = cdx * cdx + cdy * cdy;
+  double det = a_lift * (bdx_cdy - cdx_bdy) + b_lift * (cdx_ady - adx_cdy) +
+               c_lift * (adx_bdy - bdx_ady);
+  double permanent = (std::fabs(bdx_cdy) + std::fabs(cdx_bdy)) * a_lift +
+                     (std::fabs(cdx_ady) + std::fabs(adx_cdy)) * b_lift +
+                     (std::fabs(adx_bdy) + std::fabs(bdx_ady)) * c_lift;
+  double err_bound = incircle_error_bound * permanent;
+  if (det > err_bound || -det > err_bound) {
+    return det;
+  }
+  if ((adx == 0 && ady == 0) || (bdx == 0 && bdy == 0) ||
+      (cdx == 0 && cdy == 0)) {
+    return 0;
+  }
+  return InCircleExact(ax, ay, bx, by, cx, cy, dx, dy);
+}
+
+#endif  // TASK3_PREDICATES_H_
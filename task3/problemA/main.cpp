@@ -1,17 +1,39 @@
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
 
 using std::cin;
 using std::cout;
 using std::endl;
+using std::max;
+using std::min;
+using std::numeric_limits;
+using std::pair;
+using std::priority_queue;
+using std::vector;
 
-const double eps = 1e-8;
-const double c_1_divide_2 = 1.0 / 2;
-const double c_2_divide_3 = 2.0 / 3;
-const double c_1_divide_3 = 1.0 / 3;
 const double c_1 = 1.0;
 const double c_0 = 0.0;
+const size_t simd_width = 4;
+const size_t bvh_leaf_size = 4;
+const size_t no_segment = numeric_limits<size_t>::max();
+const double inf = numeric_limits<double>::infinity();
+const unsigned self_check_seed = 2019;
+const size_t self_check_rounds = 200;
+const size_t self_check_nearest = 5;
+const double self_check_tolerance = 1e-9;
 
 struct Point {
   double x_;
@@ -43,42 +65,540 @@ struct Segment {
   }
 };
 
-Point DivideSegment(Segment segment, double coef) {
-  assert(c_0 <= coef && coef <= c_1);
-  return {coef * segment.left_.x_ + (1 - coef) * segment.right_.x_,
-          coef * segment.left_.y_ + (1 - coef) * segment.right_.y_,
-          coef * segment.left_.z_ + (1 - coef) * segment.right_.z_};
+inline double Clamp(double value) {
+  return std::min(std::max(value, c_0), c_1);
+}
+
+inline double SegmentsDistanceSquared(double ax, double ay, double az,
+                                      double bx, double by, double bz,
+                                      double cx, double cy, double cz,
+                                      double dx, double dy, double dz) {
+  double ux = bx - ax;
+  double uy = by - ay;
+  double uz = bz - az;
+  double vx = dx - cx;
+  double vy = dy - cy;
+  double vz = dz - cz;
+  double wx = ax - cx;
+  double wy = ay - cy;
+  double wz = az - cz;
+  double uu = ux * ux + uy * uy + uz * uz;
+  double uv = ux * vx + uy * vy + uz * vz;
+  double vv = vx * vx + vy * vy + vz * vz;
+  double uw = ux * wx + uy * wy + uz * wz;
+  double vw = vx * wx + vy * wy + vz * wz;
+  double uu_inv = uu > c_0 ? c_1 / uu : c_0;
+  double vv_inv = vv > c_0 ? c_1 / vv : c_0;
+  double denominator = uu * vv - uv * uv;
+  double s = denominator > c_0 ? Clamp((uv * vw - uw * vv) / denominator) : c_0;
+  double t = Clamp((uv * s + vw) * vv_inv);
+  s = Clamp((uv * t - uw) * uu_inv);
+  double x = wx + ux * s - vx * t;
+  double y = wy + uy * s - vy * t;
+  double z = wz + uz * s - vz * t;
+  return x * x + y * y + z * z;
+}
+
+double FindSquaredDistanceBetweenSegments(const Segment &seg1,
+                                          const Segment &seg2) {
+  return SegmentsDistanceSquared(
+      seg1.left_.x_, seg1.left_.y_, seg1.left_.z_, seg1.right_.x_,
+      seg1.right_.y_, seg1.right_.z_, seg2.left_.x_, seg2.left_.y_,
+      seg2.left_.z_, seg2.right_.x_, seg2.right_.y_, seg2.right_.z_);
+}
+
+double FindDistanceBetweenSegments(Segment seg1, Segment seg2) {
+  return sqrt(FindSquaredDistanceBetweenSegments(seg1, seg2));
+}
+
+struct SegmentBatch {
+  vector<double> left_xs_;
+  vector<double> left_ys_;
+  vector<double> left_zs_;
+  vector<double> right_xs_;
+  vector<double> right_ys_;
+  vector<double> right_zs_;
+
+  size_t Size() const { return left_xs_.size(); }
+  void Add(const Segment &segment) {
+    left_xs_.push_back(segment.left_.x_);
+    left_ys_.push_back(segment.left_.y_);
+    left_zs_.push_back(segment.left_.z_);
+    right_xs_.push_back(segment.right_.x_);
+    right_ys_.push_back(segment.right_.y_);
+    right_zs_.push_back(segment.right_.z_);
+  }
+};
+
+#ifdef __AVX__
+inline __m256d Clamp(__m256d value) {
+  return _mm256_min_pd(_mm256_set1_pd(c_1),
+                       _mm256_max_pd(_mm256_setzero_pd(), value));
+}
+
+// Returns numerator / denominator where denominator > 0 and zero elsewhere.
+inline __m256d DivideIfPositive(__m256d numerator, __m256d denominator) {
+  __m256d is_positive =
+      _mm256_cmp_pd(denominator, _mm256_setzero_pd(), _CMP_GT_OQ);
+  return _mm256_and_pd(is_positive, _mm256_div_pd(numerator, denominator));
+}
+
+// Four lanes of SegmentsDistanceSquared followed by sqrt.
+inline __m256d SegmentsDistance(__m256d ax, __m256d ay, __m256d az,
+                                __m256d bx, __m256d by, __m256d bz,
+                                __m256d cx, __m256d cy, __m256d cz,
+                                __m256d dx, __m256d dy, __m256d dz) {
+  __m256d ux = _mm256_sub_pd(bx, ax);
+  __m256d uy = _mm256_sub_pd(by, ay);
+  __m256d uz = _mm256_sub_pd(bz, az);
+  __m256d vx = _mm256_sub_pd(dx, cx);
+  __m256d vy = _mm256_sub_pd(dy, cy);
+  __m256d vz = _mm256_sub_pd(dz, cz);
+  __m256d wx = _mm256_sub_pd(ax, cx);
+  __m256d wy = _mm256_sub_pd(ay, cy);
+  __m256d wz = _mm256_sub_pd(az, cz);
+  auto dot = [](__m256d x1, __m256d y1, __m256d z1, __m256d x2, __m256d y2,
+                __m256d z2) {
+    return _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(x1, x2), _mm256_mul_pd(y1, y2)),
+        _mm256_mul_pd(z1, z2));
+  };
+  __m256d uu = dot(ux, uy, uz, ux, uy, uz);
+  __m256d uv = dot(ux, uy, uz, vx, vy, vz);
+  __m256d vv = dot(vx, vy, vz, vx, vy, vz);
+  __m256d uw = dot(ux, uy, uz, wx, wy, wz);
+  __m256d vw = dot(vx, vy, vz, wx, wy, wz);
+  __m256d one = _mm256_set1_pd(c_1);
+  __m256d uu_inv = DivideIfPositive(one, uu);
+  __m256d vv_inv = DivideIfPositive(one, vv);
+  __m256d denominator =
+      _mm256_sub_pd(_mm256_mul_pd(uu, vv), _mm256_mul_pd(uv, uv));
+  __m256d s = Clamp(DivideIfPositive(
+      _mm256_sub_pd(_mm256_mul_pd(uv, vw), _mm256_mul_pd(uw, vv)),
+      denominator));
+  __m256d t = Clamp(_mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(uv, s), vw),
+                                  vv_inv));
+  s = Clamp(_mm256_mul_pd(_mm256_sub_pd(_mm256_mul_pd(uv, t), uw), uu_inv));
+  __m256d x = _mm256_sub_pd(_mm256_add_pd(wx, _mm256_mul_pd(ux, s)),
+                            _mm256_mul_pd(vx, t));
+  __m256d y = _mm256_sub_pd(_mm256_add_pd(wy, _mm256_mul_pd(uy, s)),
+                            _mm256_mul_pd(vy, t));
+  __m256d z = _mm256_sub_pd(_mm256_add_pd(wz, _mm256_mul_pd(uz, s)),
+                            _mm256_mul_pd(vz, t));
+  return _mm256_sqrt_pd(dot(x, y, z, x, y, z));
+}
+#endif
+
+// Distances between the i-th segments of two batches. With AVX the pairs go
+// four at a time through explicit vector code; the scalar loop handles the
+// rest and the whole batch on other targets.
+void FindDistancesBetweenSegments(const SegmentBatch &first,
+                                  const SegmentBatch &second,
+                                  vector<double> &distances) {
+  assert(first.Size() == second.Size());
+  size_t size = first.Size();
+  distances.resize(size);
+  const double *ax = first.left_xs_.data();
+  const double *ay = first.left_ys_.data();
+  const double *az = first.left_zs_.data();
+  const double *bx = first.right_xs_.data();
+  const double *by = first.right_ys_.data();
+  const double *bz = first.right_zs_.data();
+  const double *cx = second.left_xs_.data();
+  const double *cy = second.left_ys_.data();
+  const double *cz = second.left_zs_.data();
+  const double *dx = second.right_xs_.data();
+  const double *dy = second.right_ys_.data();
+  const double *dz = second.right_zs_.data();
+  size_t k = 0;
+#ifdef __AVX__
+  for (; k + simd_width <= size; k += simd_width) {
+    _mm256_storeu_pd(
+        distances.data() + k,
+        SegmentsDistance(_mm256_loadu_pd(ax + k), _mm256_loadu_pd(ay + k),
+                         _mm256_loadu_pd(az + k), _mm256_loadu_pd(bx + k),
+                         _mm256_loadu_pd(by + k), _mm256_loadu_pd(bz + k),
+                         _mm256_loadu_pd(cx + k), _mm256_loadu_pd(cy + k),
+                         _mm256_loadu_pd(cz + k), _mm256_loadu_pd(dx + k),
+                         _mm256_loadu_pd(dy + k), _mm256_loadu_pd(dz + k)));
+  }
+#endif
+  for (; k < size; ++k) {
+    distances[k] = sqrt(SegmentsDistanceSquared(ax[k], ay[k], az[k], bx[k],
+                                                by[k], bz[k], cx[k], cy[k],
+                                                cz[k], dx[k], dy[k], dz[k]));
+  }
+}
+
+struct Box {
+  Point min_;
+  Point max_;
+  Box() : min_(inf, inf, inf), max_(-inf, -inf, -inf) {}
+  void Add(const Point &p) {
+    min_ = {min(min_.x_, p.x_), min(min_.y_, p.y_), min(min_.z_, p.z_)};
+    max_ = {max(max_.x_, p.x_), max(max_.y_, p.y_), max(max_.z_, p.z_)};
+  }
+  void Add(const Box &box) {
+    Add(box.min_);
+    Add(box.max_);
+  }
+  double Extent() const {
+    return max(max_.x_ - min_.x_, max(max_.y_ - min_.y_, max_.z_ - min_.z_));
+  }
+};
+
+double AxisGap(double min1, double max1, double min2, double max2) {
+  return max(c_0, max(min1 - max2, min2 - max1));
+}
+
+double SquaredDistance(const Box &box1, const Box &box2) {
+  double x = AxisGap(box1.min_.x_, box1.max_.x_, box2.min_.x_, box2.max_.x_);
+  double y = AxisGap(box1.min_.y_, box1.max_.y_, box2.min_.y_, box2.max_.y_);
+  double z = AxisGap(box1.min_.z_, box1.max_.z_, box2.min_.z_, box2.max_.z_);
+  return x * x + y * y + z * z;
+}
+
+Box BoundingBox(const Segment &segment) {
+  Box box;
+  box.Add(segment.left_);
+  box.Add(segment.right_);
+  return box;
+}
+
+// Bounding volume hierarchy over 3D segments: median splits of the segment
+// centres along the widest axis, with boxes pruned by their distance.
+class SegmentBvh {
+ private:
+  struct Node {
+    Box box_;
+    size_t begin_;
+    size_t end_;
+    size_t left_;
+    size_t right_;
+    bool IsLeaf() const { return left_ == no_segment; }
+  };
+
+  vector<Segment> segments_;
+  vector<size_t> indices_;
+  vector<Node> nodes_;
+
+  size_t Build(size_t begin, size_t end, vector<pair<Point, size_t>> &items);
+  void Split(const SegmentBvh &other, size_t node, size_t other_node,
+             vector<pair<size_t, size_t>> &stack) const;
+
+ public:
+  explicit SegmentBvh(const vector<Segment> &segments);
+  size_t Size() const { return segments_.size(); }
+  pair<size_t, size_t> ClosestPair(const SegmentBvh &other,
+                                   double &distance) const;
+  vector<pair<double, size_t>> Nearest(const Segment &query, size_t k) const;
+  vector<pair<size_t, size_t>> WithinDistance(const SegmentBvh &other,
+                                              double threshold) const;
+};
+
+SegmentBvh::SegmentBvh(const vector<Segment> &segments)
+    : segments_(segments), indices_(segments.size()) {
+  vector<pair<Point, size_t>> items(segments.size());
+  for (size_t i = 0; i < items.size(); ++i) {
+    items[i] = {segments[i].left_ + segments[i].right_, i};
+  }
+  if (!segments_.empty()) {
+    nodes_.reserve(2 * segments_.size() / bvh_leaf_size + 1);
+    Build(0, segments_.size(), items);
+  }
+  for (size_t i = 0; i < items.size(); ++i) {
+    indices_[i] = items[i].second;
+    segments_[i] = segments[indices_[i]];
+  }
 }
-double Distance(Point end1, Point end2) { return (end1 - end2).Norm(); }
 
-double FindDistanceFromPoint(Point point_a, Segment segment) {
-  while (Distance(segment.left_, segment.right_) >= eps) {
-    Point left = DivideSegment(segment, c_2_divide_3);
-    Point right = DivideSegment(segment, c_1_divide_3);
-    if (Distance(point_a, left) < Distance(point_a, right)) {
-      segment.right_ = right;
-    } else {
-      segment.left_ = left;
+size_t SegmentBvh::Build(size_t begin, size_t end,
+                         vector<pair<Point, size_t>> &items) {
+  size_t node = nodes_.size();
+  nodes_.push_back({Box(), begin, end, no_segment, no_segment});
+  if (end - begin <= bvh_leaf_size) {
+    for (size_t i = begin; i < end; ++i) {
+      nodes_[node].box_.Add(BoundingBox(segments_[items[i].second]));
     }
+    return node;
   }
-  return Distance(point_a, DivideSegment(segment, c_1_divide_2));
+  Box center_box;
+  for (size_t i = begin; i < end; ++i) {
+    center_box.Add(items[i].first);
+  }
+  Point size = center_box.max_ - center_box.min_;
+  double Point::*axis = &Point::z_;
+  if (size.x_ >= size.y_ && size.x_ >= size.z_) {
+    axis = &Point::x_;
+  } else if (size.y_ >= size.z_) {
+    axis = &Point::y_;
+  }
+  size_t middle = begin + (end - begin) / 2;
+  std::nth_element(items.begin() + static_cast<long>(begin),
+                   items.begin() + static_cast<long>(middle),
+                   items.begin() + static_cast<long>(end),
+                   [axis](const pair<Point, size_t> &a,
+                          const pair<Point, size_t> &b) {
+                     return a.first.*axis < b.first.*axis;
+                   });
+  size_t left = Build(begin, middle, items);
+  size_t right = Build(middle, end, items);
+  nodes_[node].left_ = left;
+  nodes_[node].right_ = right;
+  nodes_[node].box_.Add(nodes_[left].box_);
+  nodes_[node].box_.Add(nodes_[right].box_);
+  return node;
 }
 
-double FindDistanceBetweenSegments(Segment seg1, Segment seg2) {
-  while (Distance(seg1.left_, seg1.right_) >= eps) {
-    Point left = DivideSegment(seg1, c_2_divide_3);
-    Point right = DivideSegment(seg1, c_1_divide_3);
-    if (FindDistanceFromPoint(left, seg2) <
-        FindDistanceFromPoint(right, seg2)) {
-      seg1.right_ = right;
-    } else {
-      seg1.left_ = left;
+void SegmentBvh::Split(const SegmentBvh &other, size_t node,
+                       size_t other_node,
+                       vector<pair<size_t, size_t>> &stack) const {
+  const Node &first = nodes_[node];
+  const Node &second = other.nodes_[other_node];
+  pair<size_t, size_t> near;
+  pair<size_t, size_t> far;
+  if (second.IsLeaf() ||
+      (!first.IsLeaf() && first.box_.Extent() >= second.box_.Extent())) {
+    near = {first.left_, other_node};
+    far = {first.right_, other_node};
+    if (SquaredDistance(nodes_[far.first].box_, second.box_) <
+        SquaredDistance(nodes_[near.first].box_, second.box_)) {
+      std::swap(near, far);
+    }
+  } else {
+    near = {node, second.left_};
+    far = {node, second.right_};
+    if (SquaredDistance(first.box_, other.nodes_[far.second].box_) <
+        SquaredDistance(first.box_, other.nodes_[near.second].box_)) {
+      std::swap(near, far);
+    }
+  }
+  stack.push_back(far);
+  stack.push_back(near);
+}
+
+pair<size_t, size_t> SegmentBvh::ClosestPair(const SegmentBvh &other,
+                                             double &distance) const {
+  pair<size_t, size_t> best = {no_segment, no_segment};
+  double best_distance = inf;
+  if (nodes_.empty() || other.nodes_.empty()) {
+    distance = best_distance;
+    return best;
+  }
+  vector<pair<size_t, size_t>> stack = {{0, 0}};
+  while (!stack.empty()) {
+    size_t node = stack.back().first;
+    size_t other_node = stack.back().second;
+    stack.pop_back();
+    const Node &first = nodes_[node];
+    const Node &second = other.nodes_[other_node];
+    if (SquaredDistance(first.box_, second.box_) >= best_distance) {
+      continue;
+    }
+    if (!first.IsLeaf() || !second.IsLeaf()) {
+      Split(other, node, other_node, stack);
+      continue;
+    }
+    for (size_t i = first.begin_; i < first.end_; ++i) {
+      for (size_t j = second.begin_; j < second.end_; ++j) {
+        double candidate = FindSquaredDistanceBetweenSegments(
+            segments_[i], other.segments_[j]);
+        if (candidate < best_distance) {
+          best_distance = candidate;
+          best = {indices_[i], other.indices_[j]};
+        }
+      }
+    }
+  }
+  distance = sqrt(best_distance);
+  return best;
+}
+
+vector<pair<double, size_t>> SegmentBvh::Nearest(const Segment &query,
+                                                 size_t k) const {
+  priority_queue<pair<double, size_t>> nearest;
+  if (k == 0 || nodes_.empty()) {
+    return {};
+  }
+  Box query_box = BoundingBox(query);
+  auto bound = [&nearest, k]() {
+    return nearest.size() < k ? inf : nearest.top().first;
+  };
+  vector<size_t> stack = {0};
+  while (!stack.empty()) {
+    const Node &node = nodes_[stack.back()];
+    stack.pop_back();
+    if (SquaredDistance(node.box_, query_box) >= bound()) {
+      continue;
+    }
+    if (!node.IsLeaf()) {
+      size_t near = node.left_;
+      size_t far = node.right_;
+      if (SquaredDistance(nodes_[far].box_, query_box) <
+          SquaredDistance(nodes_[near].box_, query_box)) {
+        std::swap(near, far);
+      }
+      stack.push_back(far);
+      stack.push_back(near);
+      continue;
+    }
+    for (size_t i = node.begin_; i < node.end_; ++i) {
+      double candidate =
+          FindSquaredDistanceBetweenSegments(segments_[i], query);
+      if (candidate < bound()) {
+        if (nearest.size() == k) {
+          nearest.pop();
+        }
+        nearest.emplace(candidate, indices_[i]);
+      }
+    }
+  }
+  vector<pair<double, size_t>> result;
+  while (!nearest.empty()) {
+    result.emplace_back(sqrt(nearest.top().first), nearest.top().second);
+    nearest.pop();
+  }
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+vector<pair<size_t, size_t>> SegmentBvh::WithinDistance(
+    const SegmentBvh &other, double threshold) const {
+  vector<pair<size_t, size_t>> result;
+  if (nodes_.empty() || other.nodes_.empty() || threshold < 0) {
+    return result;
+  }
+  double squared_threshold = threshold * threshold;
+  vector<pair<size_t, size_t>> stack = {{0, 0}};
+  while (!stack.empty()) {
+    size_t node = stack.back().first;
+    size_t other_node = stack.back().second;
+    stack.pop_back();
+    const Node &first = nodes_[node];
+    const Node &second = other.nodes_[other_node];
+    if (SquaredDistance(first.box_, second.box_) > squared_threshold) {
+      continue;
+    }
+    if (!first.IsLeaf() || !second.IsLeaf()) {
+      Split(other, node, other_node, stack);
+      continue;
+    }
+    for (size_t i = first.begin_; i < first.end_; ++i) {
+      for (size_t j = second.begin_; j < second.end_; ++j) {
+        if (FindSquaredDistanceBetweenSegments(segments_[i],
+                                               other.segments_[j]) <=
+            squared_threshold) {
+          result.emplace_back(indices_[i], other.indices_[j]);
+        }
+      }
     }
   }
-  return FindDistanceFromPoint(DivideSegment(seg1, c_1_divide_2), seg2);
+  return result;
 }
 
-int main() {
+Segment RandomSegment(std::mt19937 &random, double spread) {
+  std::uniform_real_distribution<double> coordinate(-spread, spread);
+  Point left(coordinate(random), coordinate(random), coordinate(random));
+  if (random() % 8 == 0) {
+    return {left, left};
+  }
+  return {left, left + Point(coordinate(random), coordinate(random),
+                             coordinate(random)) +
+                    Point(coordinate(random), coordinate(random),
+                          coordinate(random))};
+}
+
+// Compares every SegmentBvh query and the batch kernel with brute force over
+// random inputs. Returns the number of mismatches.
+size_t SelfCheck() {
+  std::mt19937 random(self_check_seed);
+  size_t mismatches = 0;
+  for (size_t round = 0; round < self_check_rounds; ++round) {
+    double spread = round % 2 == 0 ? 10.0 : 0.01;
+    vector<Segment> first(random() % 300);
+    vector<Segment> second(random() % 300);
+    for (Segment &segment : first) {
+      segment = RandomSegment(random, spread);
+    }
+    for (Segment &segment : second) {
+      segment = RandomSegment(random, spread);
+    }
+    SegmentBvh first_bvh(first);
+    SegmentBvh second_bvh(second);
+    double closest = inf;
+    for (const Segment &a : first) {
+      for (const Segment &b : second) {
+        closest = min(closest, FindDistanceBetweenSegments(a, b));
+      }
+    }
+    double distance;
+    pair<size_t, size_t> found = first_bvh.ClosestPair(second_bvh, distance);
+    if (distance != closest ||
+        (found.first != no_segment &&
+         FindDistanceBetweenSegments(first[found.first],
+                                     second[found.second]) != distance)) {
+      ++mismatches;
+    }
+    vector<pair<size_t, size_t>> within;
+    double threshold = 2 * closest + spread / 10;
+    for (size_t i = 0; i < first.size(); ++i) {
+      for (size_t j = 0; j < second.size(); ++j) {
+        if (FindSquaredDistanceBetweenSegments(first[i], second[j]) <=
+            threshold * threshold) {
+          within.emplace_back(i, j);
+        }
+      }
+    }
+    vector<pair<size_t, size_t>> within_bvh =
+        first_bvh.WithinDistance(second_bvh, threshold);
+    sort(within_bvh.begin(), within_bvh.end());
+    mismatches += within_bvh != within ? 1 : 0;
+    for (const Segment &query : second) {
+      vector<double> nearest;
+      for (const Segment &segment : first) {
+        nearest.push_back(FindDistanceBetweenSegments(segment, query));
+      }
+      sort(nearest.begin(), nearest.end());
+      nearest.resize(min(nearest.size(), self_check_nearest));
+      vector<pair<double, size_t>> nearest_bvh =
+          first_bvh.Nearest(query, self_check_nearest);
+      bool same = nearest_bvh.size() == nearest.size();
+      for (size_t i = 0; same && i < nearest.size(); ++i) {
+        same = nearest_bvh[i].first == nearest[i] &&
+               FindDistanceBetweenSegments(first[nearest_bvh[i].second],
+                                           query) == nearest[i];
+      }
+      mismatches += same ? 0 : 1;
+    }
+    SegmentBatch first_batch;
+    SegmentBatch second_batch;
+    size_t size = min(first.size(), second.size());
+    for (size_t i = 0; i < size; ++i) {
+      first_batch.Add(first[i]);
+      second_batch.Add(second[i]);
+    }
+    vector<double> distances;
+    FindDistancesBetweenSegments(first_batch, second_batch, distances);
+    for (size_t i = 0; i < size; ++i) {
+      double expected = FindDistanceBetweenSegments(first[i], second[i]);
+      if (fabs(distances[i] - expected) >
+          self_check_tolerance * max(c_1, expected)) {
+        ++mismatches;
+      }
+    }
+  }
+  return mismatches;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && strcmp(argv[1], "--self-check") == 0) {
+    size_t mismatches = SelfCheck();
+    if (mismatches != 0) {
+      fprintf(stderr, "%zu mismatches with brute force\n", mismatches);
+      return 1;
+    }
+    return 0;
+  }
   Segment seg1;
   Segment seg2;
   cin >> seg1 >> seg2;
@@ -1,28 +1,269 @@
 #include <algorithm>
 #include <cmath>
-#include <iostream>
-#include <queue>
-#include <stack>
-#include <unordered_map>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
-using std::cin;
-using std::cout;
-using std::endl;
+#include "../predicates.h"
+
 using std::fabs;
-using std::hash;
 using std::max;
 using std::min;
 using std::pair;
-using std::queue;
 using std::sort;
-using std::stack;
-using std::unordered_map;
+using std::string;
 using std::vector;
 
 const double inf = 1e9;
 const double eps = 1e-9;
 const size_t count_faces_of_tetrahedron = 4;
+const size_t count_vertices_of_face = 3;
+const size_t min_points_per_thread = size_t(1) << 14;
+const unsigned insertion_seed = 2019;
+const int32_t no_face = -1;
+const size_t hint_grid_side = 32;
+const size_t count_cube_sides = 6;
+const size_t io_buffer_size = size_t(1) << 16;
+const size_t max_exact_power_of_10 = 22;
+const uint64_t max_exact_mantissa = uint64_t(1) << 53;
+const size_t max_number_length = 64;
+const size_t min_points_for_culling = 1024;
+const double culling_margin = 1e-10;
+const double powers_of_10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                               1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                               1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                               1e18, 1e19, 1e20, 1e21, 1e22};
+
+enum class Format { Text, Binary };
+
+class PointReader {
+ private:
+  FILE *file_;
+  Format format_;
+  vector<char> buffer_;
+  size_t pos_ = 0;
+  size_t filled_ = 0;
+
+  int Peek();
+  void SkipSpaces();
+  bool ReadToken(char *token);
+  bool ReadBytes(void *data, size_t size);
+
+ public:
+  PointReader(FILE *file, Format format)
+      : file_(file), format_(format), buffer_(io_buffer_size) {}
+  bool ReadCount(size_t &count);
+  bool ReadPoint(double &x, double &y, double &z);
+};
+
+int PointReader::Peek() {
+  if (pos_ == filled_) {
+    filled_ = fread(buffer_.data(), 1, buffer_.size(), file_);
+    pos_ = 0;
+    if (filled_ == 0) {
+      return EOF;
+    }
+  }
+  return static_cast<unsigned char>(buffer_[pos_]);
+}
+
+void PointReader::SkipSpaces() {
+  int c = Peek();
+  while (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+    ++pos_;
+    c = Peek();
+  }
+}
+
+bool PointReader::ReadToken(char *token) {
+  SkipSpaces();
+  size_t length = 0;
+  int c = Peek();
+  while (c != EOF && c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+    if (length + 1 == max_number_length) {
+      return false;
+    }
+    token[length++] = static_cast<char>(c);
+    ++pos_;
+    c = Peek();
+  }
+  token[length] = '\0';
+  return length > 0;
+}
+
+bool PointReader::ReadBytes(void *data, size_t size) {
+  char *out = static_cast<char *>(data);
+  while (size > 0) {
+    if (Peek() == EOF) {
+      return false;
+    }
+    size_t chunk = min(size, filled_ - pos_);
+    memcpy(out, buffer_.data() + pos_, chunk);
+    pos_ += chunk;
+    out += chunk;
+    size -= chunk;
+  }
+  return true;
+}
+
+double ParseDouble(const char *token) {
+  const char *c = token;
+  bool negative = *c == '-';
+  if (*c == '-' || *c == '+') {
+    ++c;
+  }
+  uint64_t mantissa = 0;
+  size_t digits = 0;
+  long exponent = 0;
+  for (; *c >= '0' && *c <= '9'; ++c, ++digits) {
+    mantissa = mantissa * 10 + static_cast<uint64_t>(*c - '0');
+  }
+  if (*c == '.') {
+    for (++c; *c >= '0' && *c <= '9'; ++c, ++digits) {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*c - '0');
+      --exponent;
+    }
+  }
+  if (*c == 'e' || *c == 'E') {
+    char *end;
+    exponent += strtol(c + 1, &end, 10);
+    c = end;
+  }
+  if (*c != '\0' || digits == 0 || digits > 19 ||
+      mantissa > max_exact_mantissa ||
+      static_cast<size_t>(std::labs(exponent)) > max_exact_power_of_10) {
+    return strtod(token, nullptr);
+  }
+  double result = static_cast<double>(mantissa);
+  if (exponent < 0) {
+    result /= powers_of_10[-exponent];
+  } else {
+    result *= powers_of_10[exponent];
+  }
+  return negative ? -result : result;
+}
+
+bool PointReader::ReadCount(size_t &count) {
+  if (format_ == Format::Binary) {
+    uint64_t value;
+    if (!ReadBytes(&value, sizeof(value))) {
+      return false;
+    }
+    count = static_cast<size_t>(value);
+    return true;
+  }
+  char token[max_number_length];
+  if (!ReadToken(token)) {
+    return false;
+  }
+  char *end;
+  count = static_cast<size_t>(strtoull(token, &end, 10));
+  return *end == '\0';
+}
+
+bool PointReader::ReadPoint(double &x, double &y, double &z) {
+  if (format_ == Format::Binary) {
+    double coordinates[3];
+    if (!ReadBytes(coordinates, sizeof(coordinates))) {
+      return false;
+    }
+    x = coordinates[0];
+    y = coordinates[1];
+    z = coordinates[2];
+    return true;
+  }
+  char token[max_number_length];
+  for (double *coordinate : {&x, &y, &z}) {
+    if (!ReadToken(token)) {
+      return false;
+    }
+    *coordinate = ParseDouble(token);
+  }
+  return true;
+}
+
+class FaceWriter {
+ private:
+  FILE *file_;
+  Format format_;
+  vector<char> buffer_;
+  bool failed_ = false;
+
+  void Write(const void *data, size_t size);
+  void WriteNumber(size_t number);
+
+ public:
+  FaceWriter(FILE *file, Format format) : file_(file), format_(format) {
+    buffer_.reserve(io_buffer_size);
+  }
+  FaceWriter(const FaceWriter &) = delete;
+  ~FaceWriter() { Flush(); }
+  void WriteCount(size_t count);
+  void WriteFace(size_t a, size_t b, size_t c);
+  // Returns false if any write so far has failed.
+  bool Flush();
+};
+
+void FaceWriter::Write(const void *data, size_t size) {
+  if (buffer_.size() + size > io_buffer_size) {
+    Flush();
+  }
+  const char *bytes = static_cast<const char *>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+void FaceWriter::WriteNumber(size_t number) {
+  char digits[max_number_length];
+  size_t length = 0;
+  do {
+    digits[max_number_length - 1 - length++] =
+        static_cast<char>('0' + number % 10);
+    number /= 10;
+  } while (number != 0);
+  Write(digits + max_number_length - length, length);
+}
+
+void FaceWriter::WriteCount(size_t count) {
+  if (format_ == Format::Binary) {
+    uint64_t value = count;
+    Write(&value, sizeof(value));
+    return;
+  }
+  WriteNumber(count);
+  Write("\n", 1);
+}
+
+void FaceWriter::WriteFace(size_t a, size_t b, size_t c) {
+  if (format_ == Format::Binary) {
+    uint32_t face[3] = {static_cast<uint32_t>(a), static_cast<uint32_t>(b),
+                        static_cast<uint32_t>(c)};
+    Write(face, sizeof(face));
+    return;
+  }
+  Write("3", 1);
+  for (size_t index : {a, b, c}) {
+    Write(" ", 1);
+    WriteNumber(index);
+  }
+  Write("\n", 1);
+}
+
+bool FaceWriter::Flush() {
+  if (fwrite(buffer_.data(), 1, buffer_.size(), file_) != buffer_.size() ||
+      fflush(file_) != 0) {
+    failed_ = true;
+  }
+  buffer_.clear();
+  return !failed_;
+}
 
 struct Point {
   double x_;
@@ -44,372 +285,899 @@ struct Point {
     return {x_ + p.x_, y_ + p.y_, z_ + p.z_, index_ + p.index_};
   }
   Point operator-() const { return {-x_, -y_, -z_, 0}; }
-  Point operator=(Point p) {
-    x_ = p.x_;
-    y_ = p.y_;
-    z_ = p.z_;
-    index_ = p.index_;
-    return *this;
+};
+
+double Orient3d(const Point &a, const Point &b, const Point &c,
+                const Point &d) {
+  return Orient3d(a.x_, a.y_, a.z_, b.x_, b.y_, b.z_, c.x_, c.y_, c.z_, d.x_,
+                  d.y_, d.z_);
+}
+
+bool IsCollinear(const Point &a, const Point &b, const Point &c) {
+  return Orient2d(a.x_, a.y_, b.x_, b.y_, c.x_, c.y_) == 0 &&
+         Orient2d(a.y_, a.z_, b.y_, b.z_, c.y_, c.z_) == 0 &&
+         Orient2d(a.z_, a.x_, b.z_, b.x_, c.z_, c.x_) == 0;
+}
+
+// Moves the first four points in general position to the front keeping the
+// order of the rest; the points passed over on the way end up right after
+// them and their number is stored in skipped. Returns false if all points
+// are coplanar.
+bool PlaceTetrahedronFirst(vector<Point> &points, size_t &skipped) {
+  if (points.empty()) {
+    return false;
+  }
+  size_t chosen = 1;
+  for (size_t i = 1; i < points.size() && chosen < count_faces_of_tetrahedron;
+       ++i) {
+    const Point &p = points[i];
+    bool is_general;
+    if (chosen == 1) {
+      is_general = p.x_ != points[0].x_ || p.y_ != points[0].y_ ||
+                   p.z_ != points[0].z_;
+    } else if (chosen == 2) {
+      is_general = !IsCollinear(points[0], points[1], p);
+    } else {
+      is_general = Orient3d(points[0], points[1], points[2], p) != 0;
+    }
+    if (is_general) {
+      std::rotate(points.begin() + static_cast<long>(chosen),
+                  points.begin() + static_cast<long>(i),
+                  points.begin() + static_cast<long>(i + 1));
+      skipped = i - chosen;
+      ++chosen;
+    }
   }
+  return chosen == count_faces_of_tetrahedron;
+}
+
+struct Face {
+  int32_t vertices_[count_vertices_of_face];
+  int32_t neighbours_[count_vertices_of_face];
 };
 
-struct OrientedSegment {
-  Point end1_;
-  Point end2_;
-  OrientedSegment() = default;
-  OrientedSegment(Point end1, Point end2) : end1_(end1), end2_(end2) {}
-  OrientedSegment operator-() const { return {end2_, end1_}; }
+struct HorizonEdge {
+  int32_t begin_;
+  int32_t end_;
+  int32_t inner_face_;
+  int32_t outer_face_;
+  size_t outer_slot_;
 };
 
-struct Triangle {
-  Point v1_;
-  Point v2_;
-  Point v3_;
-  size_t neighbour1_;
-  size_t neighbour2_;
-  size_t neighbour3_;
-  OrientedSegment intersect_neighbour1_;
-  OrientedSegment intersect_neighbour2_;
-  OrientedSegment intersect_neighbour3_;
-
-  Triangle()
-      : neighbour1_(static_cast<size_t>(inf)),
-        neighbour2_(static_cast<size_t>(inf)),
-        neighbour3_(static_cast<size_t>(inf)){};
-  Triangle(Point v1, Point v2, Point v3)
-      : v1_(v1),
-        v2_(v2),
-        v3_(v3),
-        neighbour1_(static_cast<size_t>(inf)),
-        neighbour2_(static_cast<size_t>(inf)),
-        neighbour3_(static_cast<size_t>(inf)){};
-  bool operator<(const Triangle &tr) const {
-    return v1_ < tr.v1_ || (v1_ == tr.v1_ && v2_ < tr.v2_) ||
-           (v1_ == tr.v1_ && v2_ == tr.v2_ && v3_ < tr.v3_);
-  }
-  bool operator==(const Triangle &tr) const {
-    return v1_ == tr.v1_ && v2_ == tr.v2_ && v3_ == tr.v3_;
-  }
-
-  void SwapNeighbour(size_t old, size_t update);
+enum class InsertionOrder { SortedByX, Randomized };
+
+using IndexFace = pair<size_t, pair<size_t, size_t>>;
+
+class ConflictGraph {
+ private:
+  vector<double> xs_;
+  vector<double> ys_;
+  vector<double> zs_;
+  vector<size_t> indices_;
+  vector<Face> faces_;
+  vector<char> is_alive_;
+  vector<int32_t> free_faces_;
+  size_t faces_count_ = 0;
+  vector<int32_t> last_added_faces_;
+  vector<int32_t> horizon_start_;
+  vector<uint32_t> visit_stamp_;
+  vector<char> is_visible_;
+  uint32_t stamp_ = 0;
+  bool use_conflict_lists_;
+  vector<vector<int32_t>> face_conflicts_;
+  vector<int32_t> point_conflict_;
+  vector<uint32_t> candidate_stamp_;
+  uint32_t candidate_round_ = 0;
+  vector<vector<int32_t>> edge_conflicts_;
+  vector<int32_t> visible_faces_;
+  vector<HorizonEdge> horizon_;
+  Point center_;
+  std::mt19937 walk_random_;
+  vector<int32_t> vertex_hints_;
+
+  Point PointAt(int32_t vertex) const;
+  bool IsFaceVisible(int32_t face, int32_t point) const;
+  bool IsVisible(int32_t a, int32_t b, int32_t c, int32_t point) const;
+  int32_t NewFace(int32_t a, int32_t b, int32_t c);
+  void DeleteFace(int32_t face);
+  void BuildTetrahedron();
+  int32_t FindVisionFace(int32_t point) const;
+  void CollectEdgeConflicts(const HorizonEdge &edge, int32_t point,
+                            vector<int32_t> &conflicts);
+  void CollectVisibleFaces(int32_t vision_face, int32_t point);
+  size_t HintCell(int32_t point) const;
+  int32_t HintFace(int32_t point) const;
+  int32_t LocateFace(int32_t point);
+  void ReplaceVisibleFaces(int32_t vision_face, int32_t point);
+  void AddPoint(int32_t point);
+  void Clear();
+  IndexFace CanonicalFace(size_t face) const;
+
+ public:
+  class FaceIterator {
+   private:
+    const ConflictGraph *graph_;
+    size_t face_;
+
+    void SkipDeleted() {
+      while (face_ < graph_->faces_.size() && !graph_->is_alive_[face_]) {
+        ++face_;
+      }
+    }
+
+   public:
+    FaceIterator(const ConflictGraph *graph, size_t face)
+        : graph_(graph), face_(face) {
+      SkipDeleted();
+    }
+    IndexFace operator*() const { return graph_->CanonicalFace(face_); }
+    FaceIterator &operator++() {
+      ++face_;
+      SkipDeleted();
+      return *this;
+    }
+    bool operator!=(const FaceIterator &other) const {
+      return face_ != other.face_;
+    }
+  };
+
+  struct FaceRange {
+    FaceIterator begin_;
+    FaceIterator end_;
+    FaceIterator begin() const { return begin_; }
+    FaceIterator end() const { return end_; }
+  };
+
+  ConflictGraph() : use_conflict_lists_(false) {}
+  explicit ConflictGraph(const vector<Point> &ordered_points,
+                         InsertionOrder order = InsertionOrder::SortedByX);
+  bool Build(const vector<Point> &ordered_points,
+             InsertionOrder order = InsertionOrder::SortedByX);
+  // Adds p to a hull made by Build. Returns false if p is not outside the
+  // hull or if there is no hull yet. The face under p is found by a walk
+  // that starts at the last vertex added in p's direction from the centre,
+  // so its length depends on how far that vertex is from p rather than on
+  // the size of the hull.
+  bool Insert(const Point &p);
+  FaceRange Faces() const {
+    return {FaceIterator(this, 0), FaceIterator(this, faces_.size())};
+  }
+  size_t FacesCount() const { return faces_count_; }
+  vector<Point> HullVertices() const;
+  vector<IndexFace> SortedFaces() const;
+  void OutputHill(FaceWriter &writer);
 };
 
-void Triangle::SwapNeighbour(size_t old, size_t update) {
-  if (neighbour1_ == old) {
-    neighbour1_ = update;
-  } else if (neighbour2_ == old) {
-    neighbour2_ = update;
-  } else {
-    neighbour3_ = update;
+ConflictGraph::ConflictGraph(const vector<Point> &ordered_points,
+                             InsertionOrder order) {
+  Build(ordered_points, order);
+}
+
+void ConflictGraph::Clear() {
+  xs_.clear();
+  ys_.clear();
+  zs_.clear();
+  indices_.clear();
+  faces_.clear();
+  is_alive_.clear();
+  free_faces_.clear();
+  faces_count_ = 0;
+  last_added_faces_.clear();
+  horizon_start_.clear();
+  visit_stamp_.clear();
+  is_visible_.clear();
+  stamp_ = 0;
+  face_conflicts_.clear();
+  point_conflict_.clear();
+  candidate_stamp_.clear();
+  candidate_round_ = 0;
+  vertex_hints_.assign(count_cube_sides * hint_grid_side * hint_grid_side,
+                       no_face);
+}
+
+bool ConflictGraph::Build(const vector<Point> &ordered_points,
+                          InsertionOrder order) {
+  Clear();
+  use_conflict_lists_ = order == InsertionOrder::Randomized;
+  vector<Point> points = ordered_points;
+  if (use_conflict_lists_) {
+    std::shuffle(points.begin(), points.end(), std::mt19937(insertion_seed));
+  }
+  size_t skipped = 0;
+  if (!PlaceTetrahedronFirst(points, skipped)) {
+    return false;
+  }
+  xs_.reserve(points.size());
+  ys_.reserve(points.size());
+  zs_.reserve(points.size());
+  indices_.reserve(points.size());
+  for (const Point &p : points) {
+    xs_.push_back(p.x_);
+    ys_.push_back(p.y_);
+    zs_.push_back(p.z_);
+    indices_.push_back(p.index_);
+  }
+  horizon_start_.resize(points.size(), no_face);
+  BuildTetrahedron();
+  center_ = Point(0, 0, 0, 0);
+  for (int32_t i = 0; i < static_cast<int32_t>(count_faces_of_tetrahedron);
+       ++i) {
+    center_ = center_ + PointAt(i);
+  }
+  center_.x_ /= count_faces_of_tetrahedron;
+  center_.y_ /= count_faces_of_tetrahedron;
+  center_.z_ /= count_faces_of_tetrahedron;
+  for (int32_t i = 0; i < static_cast<int32_t>(count_faces_of_tetrahedron);
+       ++i) {
+    vertex_hints_[HintCell(i)] = i;
+  }
+  int32_t size = static_cast<int32_t>(points.size());
+  int32_t first = static_cast<int32_t>(count_faces_of_tetrahedron);
+  if (use_conflict_lists_) {
+    point_conflict_.resize(points.size(), no_face);
+    candidate_stamp_.resize(points.size(), 0);
+    for (int32_t i = first; i < size; ++i) {
+      for (int32_t face : last_added_faces_) {
+        if (IsFaceVisible(face, i)) {
+          face_conflicts_[static_cast<size_t>(face)].push_back(i);
+          point_conflict_[static_cast<size_t>(i)] = face;
+        }
+      }
+    }
+  } else if (skipped > 0) {
+    // The passed over points come before the last tetrahedron vertex in
+    // x order, so they are located by a walk instead.
+    for (; first < static_cast<int32_t>(count_faces_of_tetrahedron + skipped);
+         ++first) {
+      int32_t face = LocateFace(first);
+      if (IsFaceVisible(face, first)) {
+        ReplaceVisibleFaces(face, first);
+      }
+    }
+    int32_t last = static_cast<int32_t>(count_faces_of_tetrahedron - 1);
+    last_added_faces_.clear();
+    for (size_t i = 0; i < faces_.size(); ++i) {
+      const int32_t *v = faces_[i].vertices_;
+      if (is_alive_[i] && (v[0] == last || v[1] == last || v[2] == last)) {
+        last_added_faces_.push_back(static_cast<int32_t>(i));
+      }
+    }
+  }
+  for (int32_t i = first; i < size; ++i) {
+    AddPoint(i);
   }
+  return true;
 }
 
-Point VectorMult(const Point &a, const Point &b) {
-  return {a.y_ * b.z_ - a.z_ * b.y_, a.z_ * b.x_ - a.x_ * b.z_,
-          a.x_ * b.y_ - a.y_ * b.x_, 0};
+Point ConflictGraph::PointAt(int32_t vertex) const {
+  size_t v = static_cast<size_t>(vertex);
+  return {xs_[v], ys_[v], zs_[v], indices_[v]};
 }
 
-double ScalarMult(const Point &a, const Point &b) {
-  return a.x_ * b.x_ + a.y_ * b.y_ + a.z_ * b.z_;
+bool ConflictGraph::IsFaceVisible(int32_t face, int32_t point) const {
+  const Face &f = faces_[static_cast<size_t>(face)];
+  return IsVisible(f.vertices_[0], f.vertices_[1], f.vertices_[2], point);
 }
 
-bool IsTriangleVisible(Point view, Triangle tr) {
-  Point normal = VectorMult(tr.v3_ - tr.v2_, tr.v1_ - tr.v2_);
-  return ScalarMult(normal, view - tr.v1_) > 0 &&
-         ScalarMult(normal, view - tr.v2_) > 0 &&
-         ScalarMult(normal, view - tr.v3_) > 0;
+bool ConflictGraph::IsVisible(int32_t a, int32_t b, int32_t c,
+                              int32_t point) const {
+  return Orient3d(PointAt(a), PointAt(b), PointAt(c), PointAt(point)) < 0;
 }
 
-Triangle MakeNewTriangle(OrientedSegment s, Point p) {
-  if (min(p.index_, min(s.end1_.index_, s.end2_.index_)) == p.index_) {
-    return {p, s.end2_, s.end1_};
-  }
-  if (min(p.index_, min(s.end1_.index_, s.end2_.index_)) == s.end1_.index_) {
-    return {s.end1_, p, s.end2_};
+int32_t ConflictGraph::NewFace(int32_t a, int32_t b, int32_t c) {
+  int32_t face;
+  if (free_faces_.empty()) {
+    face = static_cast<int32_t>(faces_.size());
+    faces_.push_back({{a, b, c}, {no_face, no_face, no_face}});
+    is_alive_.push_back(1);
+    visit_stamp_.push_back(0);
+    is_visible_.push_back(0);
+    if (use_conflict_lists_) {
+      face_conflicts_.emplace_back();
+    }
+  } else {
+    face = free_faces_.back();
+    free_faces_.pop_back();
+    faces_[static_cast<size_t>(face)] = {{a, b, c},
+                                         {no_face, no_face, no_face}};
+    is_alive_[static_cast<size_t>(face)] = 1;
   }
-  return {s.end2_, s.end1_, p};
+  ++faces_count_;
+  return face;
 }
 
-template <>
-class std::hash<Point> {
- public:
-  size_t operator()(const Point &p) const {
-    size_t h1 = hash<double>()(p.x_);
-    size_t h2 = hash<double>()(p.y_);
-    size_t h3 = hash<double>()(p.z_);
-    return h1 * h2 * h3;
-  }
-};
+void ConflictGraph::DeleteFace(int32_t face) {
+  is_alive_[static_cast<size_t>(face)] = 0;
+  free_faces_.push_back(face);
+  --faces_count_;
+}
 
-template <>
-class std::hash<Triangle> {
- public:
-  size_t operator()(const Triangle &tr) const {
-    size_t h1 = hash<Point>()(tr.v1_);
-    size_t h2 = hash<Point>()(tr.v2_);
-    size_t h3 = hash<Point>()(tr.v3_);
-    return h1 * h2 * h3;
+void ConflictGraph::BuildTetrahedron() {
+  const int32_t tetrahedron[count_faces_of_tetrahedron][count_vertices_of_face] =
+      {{0, 1, 2}, {0, 1, 3}, {0, 2, 3}, {1, 2, 3}};
+  for (size_t i = 0; i < count_faces_of_tetrahedron; ++i) {
+    int32_t a = tetrahedron[i][0];
+    int32_t b = tetrahedron[i][1];
+    int32_t c = tetrahedron[i][2];
+    int32_t opposite = static_cast<int32_t>(count_faces_of_tetrahedron - 1 - i);
+    if (Orient3d(PointAt(a), PointAt(b), PointAt(c), PointAt(opposite)) < 0) {
+      std::swap(b, c);
+    }
+    last_added_faces_.push_back(NewFace(a, b, c));
+    for (int32_t v : {a, b, c}) {
+      horizon_start_[static_cast<size_t>(v)] = last_added_faces_.back();
+    }
   }
-};
-
-template <typename T>
-struct Triple {
-  T first_;
-  T second_;
-  T third_;
-  Triple(T first, T second, T third)
-      : first_(first), second_(second), third_(third){};
-};
+  for (int32_t f : last_added_faces_) {
+    for (size_t k = 0; k < count_vertices_of_face; ++k) {
+      int32_t begin = faces_[static_cast<size_t>(f)].vertices_[k];
+      int32_t end = faces_[static_cast<size_t>(f)]
+                        .vertices_[(k + 1) % count_vertices_of_face];
+      for (int32_t g : last_added_faces_) {
+        const Face &other = faces_[static_cast<size_t>(g)];
+        for (size_t j = 0; j < count_vertices_of_face; ++j) {
+          if (other.vertices_[j] == end &&
+              other.vertices_[(j + 1) % count_vertices_of_face] == begin) {
+            faces_[static_cast<size_t>(f)].neighbours_[k] = g;
+          }
+        }
+      }
+    }
+  }
+}
 
-class ConflictGraph {
- private:
-  unordered_map<size_t, Triangle> convex_hill_;
-  vector<Point> ordered_points_;
-  vector<size_t> vision_horizont_;
-  vector<size_t> last_added_faces_ = {0, 1, 2, 3};
-  size_t last_num_face_ = count_faces_of_tetrahedron;
-
-  void ConnectNewTrianglesByEnd2(size_t new_triangle_index,
-                                 Point horizont_point, Point p);
-  void ConnectNewTrianglesByEnd1(size_t new_triangle_index,
-                                 Point horizont_point, Point p);
-  void AddTriangle(Point p, OrientedSegment oriented_s, size_t old_triangle,
-                   size_t neigh_triangle);
-  void AddTwoFaces(Triangle &tr, Triple<size_t> neigh,
-                   Triple<OrientedSegment> seg);
-  size_t FindVisionFace(Point p);
-  void ProcessNeighbour(Point p, size_t current_triangle, queue<size_t> &q,
-                        size_t neighbour_triangle,
-                        OrientedSegment common_segment);
-  void AddPoint(Point p);
+int32_t ConflictGraph::FindVisionFace(int32_t point) const {
+  for (int32_t last_added_face : last_added_faces_) {
+    if (IsFaceVisible(last_added_face, point)) {
+      return last_added_face;
+    }
+  }
+  return no_face;
+}
 
- public:
-  explicit ConflictGraph(const vector<Point> &ordered_points);
-  void OutputHill();
-};
+// A point sees the new face over a horizon edge only if it saw one of the
+// two old faces meeting at that edge, so those two conflict lists are the
+// only candidates. This keeps the expected total work O(n log n) for a
+// random insertion order.
+void ConflictGraph::CollectEdgeConflicts(const HorizonEdge &edge,
+                                         int32_t point,
+                                         vector<int32_t> &conflicts) {
+  conflicts.clear();
+  ++candidate_round_;
+  for (int32_t face : {edge.inner_face_, edge.outer_face_}) {
+    for (int32_t candidate : face_conflicts_[static_cast<size_t>(face)]) {
+      uint32_t &stamp = candidate_stamp_[static_cast<size_t>(candidate)];
+      if (candidate != point && stamp != candidate_round_) {
+        stamp = candidate_round_;
+        if (IsVisible(edge.begin_, edge.end_, point, candidate)) {
+          conflicts.push_back(candidate);
+        }
+      }
+    }
+  }
+}
 
-ConflictGraph::ConflictGraph(const vector<Point> &ordered_points) {
-  ordered_points_ = ordered_points;
-  vector<Point> sort_by_index = {ordered_points_[0], ordered_points_[1],
-                                 ordered_points_[2], ordered_points_[3]};
-  sort(sort_by_index.begin(), sort_by_index.end());
-  vision_horizont_.resize(ordered_points_.size(), static_cast<size_t>(inf));
-  Point normal = VectorMult(sort_by_index[1] - sort_by_index[0],
-                            sort_by_index[2] - sort_by_index[0]);
-  Triangle first_face;
-  if (ScalarMult(sort_by_index[0] - sort_by_index[3], normal) < 0) {
-    first_face = Triangle(sort_by_index[0], sort_by_index[2], sort_by_index[1]);
-  } else {
-    first_face = Triangle(sort_by_index[0], sort_by_index[1], sort_by_index[2]);
-  }
-  Triangle f1 =
-      MakeNewTriangle({first_face.v1_, first_face.v2_}, sort_by_index[3]);
-  Triangle f2 =
-      MakeNewTriangle({first_face.v2_, first_face.v3_}, sort_by_index[3]);
-  Triangle f3 =
-      MakeNewTriangle({first_face.v3_, first_face.v1_}, sort_by_index[3]);
-  convex_hill_ = {{0, first_face}, {1, f1}, {2, f2}, {3, f3}};
-  AddTwoFaces(convex_hill_[0], {1, 2, 3},
-              {{first_face.v1_, first_face.v2_},
-               {first_face.v2_, first_face.v3_},
-               {first_face.v3_, first_face.v1_}});
-  AddTwoFaces(convex_hill_[1], {0, 3, 2},
-              {{first_face.v2_, first_face.v1_},
-               {first_face.v1_, sort_by_index[3]},
-               {sort_by_index[3], first_face.v2_}});
-  AddTwoFaces(convex_hill_[2], {0, 1, 3},
-              {{first_face.v3_, first_face.v2_},
-               {first_face.v2_, sort_by_index[3]},
-               {sort_by_index[3], first_face.v3_}});
-  AddTwoFaces(convex_hill_[3], {0, 2, 1},
-              {{first_face.v1_, first_face.v3_},
-               {first_face.v3_, sort_by_index[3]},
-               {sort_by_index[3], first_face.v1_}});
-  for (size_t i = last_num_face_; i < ordered_points_.size(); ++i) {
-    AddPoint(ordered_points_[i]);
-  }
-}
-
-void ConflictGraph::AddTwoFaces(Triangle &tr, Triple<size_t> neigh,
-                                Triple<OrientedSegment> seg) {
-  tr.neighbour1_ = neigh.first_;
-  tr.neighbour2_ = neigh.second_;
-  tr.neighbour3_ = neigh.third_;
-  tr.intersect_neighbour1_ = seg.first_;
-  tr.intersect_neighbour2_ = seg.second_;
-  tr.intersect_neighbour3_ = seg.third_;
-}
-
-void ConflictGraph::ConnectNewTrianglesByEnd1(size_t new_triangle_index,
-                                              Point horizont_point, Point p) {
-  if (vision_horizont_[horizont_point.index_] == static_cast<size_t>(inf)) {
-    vision_horizont_[horizont_point.index_] = new_triangle_index;
-  } else {
-    if (convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour2_ = {horizont_point, p};
-    } else {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour3_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour3_ = {horizont_point, p};
-    }
-
-    if (convex_hill_[new_triangle_index].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[new_triangle_index].neighbour2_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour2_ = {p,
-                                                                horizont_point};
-    } else {
-      convex_hill_[new_triangle_index].neighbour3_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour3_ = {p,
-                                                                horizont_point};
+void ConflictGraph::CollectVisibleFaces(int32_t vision_face, int32_t point) {
+  ++stamp_;
+  visible_faces_.clear();
+  horizon_.clear();
+  visit_stamp_[static_cast<size_t>(vision_face)] = stamp_;
+  is_visible_[static_cast<size_t>(vision_face)] = 1;
+  vector<int32_t> stack = {vision_face};
+  while (!stack.empty()) {
+    int32_t current = stack.back();
+    stack.pop_back();
+    visible_faces_.push_back(current);
+    const Face &f = faces_[static_cast<size_t>(current)];
+    for (size_t k = 0; k < count_vertices_of_face; ++k) {
+      size_t neighbour = static_cast<size_t>(f.neighbours_[k]);
+      if (visit_stamp_[neighbour] != stamp_) {
+        visit_stamp_[neighbour] = stamp_;
+        is_visible_[neighbour] =
+            IsFaceVisible(f.neighbours_[k], point) ? 1 : 0;
+        if (is_visible_[neighbour]) {
+          stack.push_back(f.neighbours_[k]);
+        }
+      }
+      if (!is_visible_[neighbour]) {
+        size_t slot = 0;
+        while (faces_[neighbour].neighbours_[slot] != current) {
+          ++slot;
+        }
+        horizon_.push_back({f.vertices_[k],
+                            f.vertices_[(k + 1) % count_vertices_of_face],
+                            current, f.neighbours_[k], slot});
+      }
     }
-    vision_horizont_[horizont_point.index_] = static_cast<size_t>(inf);
   }
 }
 
-void ConflictGraph::ConnectNewTrianglesByEnd2(size_t new_triangle_index,
-                                              Point horizont_point, Point p) {
-  if (vision_horizont_[horizont_point.index_] == static_cast<size_t>(inf)) {
-    vision_horizont_[horizont_point.index_] = new_triangle_index;
-  } else {
-    if (convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour2_ = {p, horizont_point};
-    } else {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour3_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour3_ = {p, horizont_point};
-    }
-
-    if (convex_hill_[new_triangle_index].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[new_triangle_index].neighbour2_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour2_ = {horizont_point,
-                                                                p};
-    } else {
-      convex_hill_[new_triangle_index].neighbour3_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour3_ = {horizont_point,
-                                                                p};
+// Directions from the centre are bucketed by the side of the cube they
+// leave through and a hint_grid_side x hint_grid_side grid on that side.
+size_t ConflictGraph::HintCell(int32_t point) const {
+  Point d = PointAt(point) - center_;
+  double coordinates[] = {d.x_, d.y_, d.z_};
+  size_t axis = 0;
+  for (size_t i = 1; i < 3; ++i) {
+    if (fabs(coordinates[i]) > fabs(coordinates[axis])) {
+      axis = i;
     }
-    vision_horizont_[horizont_point.index_] = static_cast<size_t>(inf);
   }
+  double scale = fabs(coordinates[axis]);
+  size_t cell = 2 * axis + (coordinates[axis] < 0 ? 1 : 0);
+  for (size_t i = 1; i < 3; ++i) {
+    double t = scale == 0 ? 0 : coordinates[(axis + i) % 3] / scale;
+    size_t row = static_cast<size_t>((t + 1) / 2 *
+                                     static_cast<double>(hint_grid_side));
+    cell = cell * hint_grid_side + min(row, hint_grid_side - 1);
+  }
+  return cell;
 }
 
-void ConflictGraph::AddTriangle(Point p, OrientedSegment oriented_s,
-                                size_t old_triangle, size_t neigh_triangle) {
-  Triangle new_tr = MakeNewTriangle(-oriented_s, p);
-  convex_hill_.emplace(last_num_face_, new_tr);
-  convex_hill_[neigh_triangle].SwapNeighbour(old_triangle, last_num_face_);
-  convex_hill_[last_num_face_].neighbour1_ = neigh_triangle;
-  convex_hill_[last_num_face_].intersect_neighbour1_ = oriented_s;
-  ConnectNewTrianglesByEnd1(last_num_face_, oriented_s.end1_, p);
-  ConnectNewTrianglesByEnd2(last_num_face_, oriented_s.end2_, p);
-  last_added_faces_.push_back(last_num_face_);
-  ++last_num_face_;
+// A vertex is still on the hull exactly when the face recorded in
+// horizon_start_ for it is alive and contains it: a later cone that keeps
+// the vertex has it on its horizon and records a new face.
+int32_t ConflictGraph::HintFace(int32_t point) const {
+  int32_t vertex = vertex_hints_[HintCell(point)];
+  if (vertex != no_face) {
+    int32_t face = horizon_start_[static_cast<size_t>(vertex)];
+    if (face != no_face && is_alive_[static_cast<size_t>(face)]) {
+      for (int32_t v : faces_[static_cast<size_t>(face)].vertices_) {
+        if (v == vertex) {
+          return face;
+        }
+      }
+    }
+  }
+  return last_added_faces_.front();
 }
 
-size_t ConflictGraph::FindVisionFace(Point p) {
-  for (size_t last_added_face : last_added_faces_) {
-    if (IsTriangleVisible(p, convex_hill_[last_added_face])) {
-      return last_added_face;
+int32_t ConflictGraph::LocateFace(int32_t point) {
+  Point p = PointAt(point);
+  int32_t current = HintFace(point);
+  bool moved = true;
+  while (moved) {
+    moved = false;
+    const Face &f = faces_[static_cast<size_t>(current)];
+    size_t start = walk_random_() % count_vertices_of_face;
+    for (size_t i = 0; i < count_vertices_of_face && !moved; ++i) {
+      size_t k = (start + i) % count_vertices_of_face;
+      Point a = PointAt(f.vertices_[k]);
+      Point b = PointAt(f.vertices_[(k + 1) % count_vertices_of_face]);
+      if (Orient3d(center_, a, b, p) > 0) {
+        current = f.neighbours_[k];
+        moved = true;
+      }
     }
   }
-  return static_cast<size_t>(inf);
+  return current;
 }
 
-void ConflictGraph::ProcessNeighbour(Point p, size_t current_triangle,
-                                     queue<size_t> &q,
-                                     size_t neighbour_triangle,
-                                     OrientedSegment common_segment) {
-  if (convex_hill_.find(neighbour_triangle) == convex_hill_.end()) {
-    return;
+bool ConflictGraph::Insert(const Point &p) {
+  if (faces_count_ == 0) {
+    return false;
+  }
+  xs_.push_back(p.x_);
+  ys_.push_back(p.y_);
+  zs_.push_back(p.z_);
+  indices_.push_back(p.index_);
+  horizon_start_.push_back(no_face);
+  if (use_conflict_lists_) {
+    point_conflict_.push_back(no_face);
+    candidate_stamp_.push_back(0);
+  }
+  int32_t point = static_cast<int32_t>(xs_.size() - 1);
+  int32_t face = LocateFace(point);
+  if (!IsFaceVisible(face, point)) {
+    xs_.pop_back();
+    ys_.pop_back();
+    zs_.pop_back();
+    indices_.pop_back();
+    horizon_start_.pop_back();
+    if (use_conflict_lists_) {
+      point_conflict_.pop_back();
+      candidate_stamp_.pop_back();
+    }
+    return false;
   }
+  ReplaceVisibleFaces(face, point);
+  return true;
+}
 
-  if (!IsTriangleVisible(p, convex_hill_[neighbour_triangle])) {
-    AddTriangle(p, common_segment, current_triangle, neighbour_triangle);
-  } else {
-    q.push(neighbour_triangle);
+void ConflictGraph::AddPoint(int32_t point) {
+  int32_t vision_face = use_conflict_lists_
+                            ? point_conflict_[static_cast<size_t>(point)]
+                            : FindVisionFace(point);
+  if (vision_face != no_face) {
+    ReplaceVisibleFaces(vision_face, point);
   }
 }
 
-void ConflictGraph::AddPoint(Point p) {
-  size_t vision_face = FindVisionFace(p);
-  if (vision_face == static_cast<size_t>(inf)) {
-    return;
+void ConflictGraph::ReplaceVisibleFaces(int32_t vision_face, int32_t point) {
+  CollectVisibleFaces(vision_face, point);
+  if (use_conflict_lists_) {
+    if (edge_conflicts_.size() < horizon_.size()) {
+      edge_conflicts_.resize(horizon_.size());
+    }
+    for (size_t i = 0; i < horizon_.size(); ++i) {
+      CollectEdgeConflicts(horizon_[i], point, edge_conflicts_[i]);
+    }
+    for (int32_t face : visible_faces_) {
+      for (int32_t orphan : face_conflicts_[static_cast<size_t>(face)]) {
+        if (point_conflict_[static_cast<size_t>(orphan)] == face) {
+          point_conflict_[static_cast<size_t>(orphan)] = no_face;
+        }
+      }
+      face_conflicts_[static_cast<size_t>(face)].clear();
+    }
+  }
+  for (int32_t face : visible_faces_) {
+    DeleteFace(face);
   }
   last_added_faces_.clear();
-  queue<size_t> q;
-  q.push(vision_face);
-  while (!q.empty()) {
-    size_t current_triangle = q.front();
-    q.pop();
-    if (convex_hill_.find(current_triangle) == convex_hill_.end()) {
+  for (size_t i = 0; i < horizon_.size(); ++i) {
+    const HorizonEdge &edge = horizon_[i];
+    int32_t face = NewFace(edge.begin_, edge.end_, point);
+    if (use_conflict_lists_) {
+      face_conflicts_[static_cast<size_t>(face)].swap(edge_conflicts_[i]);
+      for (int32_t conflict : face_conflicts_[static_cast<size_t>(face)]) {
+        point_conflict_[static_cast<size_t>(conflict)] = face;
+      }
+    }
+    faces_[static_cast<size_t>(face)].neighbours_[0] = edge.outer_face_;
+    faces_[static_cast<size_t>(edge.outer_face_)]
+        .neighbours_[edge.outer_slot_] = face;
+    horizon_start_[static_cast<size_t>(edge.begin_)] = face;
+    last_added_faces_.push_back(face);
+  }
+  for (int32_t face : last_added_faces_) {
+    Face &f = faces_[static_cast<size_t>(face)];
+    int32_t next = horizon_start_[static_cast<size_t>(f.vertices_[1])];
+    f.neighbours_[1] = next;
+    faces_[static_cast<size_t>(next)].neighbours_[2] = face;
+  }
+  vertex_hints_[HintCell(point)] = point;
+}
+
+vector<Point> ConflictGraph::HullVertices() const {
+  vector<bool> is_vertex(xs_.size(), false);
+  vector<Point> result;
+  for (size_t i = 0; i < faces_.size(); ++i) {
+    if (!is_alive_[i]) {
       continue;
     }
-    ProcessNeighbour(p, current_triangle, q,
-                     convex_hill_[current_triangle].neighbour1_,
-                     convex_hill_[current_triangle].intersect_neighbour1_);
-    ProcessNeighbour(p, current_triangle, q,
-                     convex_hill_[current_triangle].neighbour2_,
-                     convex_hill_[current_triangle].intersect_neighbour2_);
-    ProcessNeighbour(p, current_triangle, q,
-                     convex_hill_[current_triangle].neighbour3_,
-                     convex_hill_[current_triangle].intersect_neighbour3_);
-    convex_hill_.erase(current_triangle);
+    for (int32_t v : faces_[i].vertices_) {
+      if (!is_vertex[static_cast<size_t>(v)]) {
+        is_vertex[static_cast<size_t>(v)] = true;
+        result.push_back(PointAt(v));
+      }
+    }
   }
+  return result;
 }
 
-void ConflictGraph::OutputHill() {
-  cout << convex_hill_.size() << endl;
-  vector<pair<int, pair<int, int> > > res;
-  for (auto &i : convex_hill_) {
-    res.push_back(
-        {i.second.v1_.index_, {i.second.v2_.index_, i.second.v3_.index_}});
+IndexFace ConflictGraph::CanonicalFace(size_t face) const {
+  size_t v[count_vertices_of_face];
+  for (size_t k = 0; k < count_vertices_of_face; ++k) {
+    v[k] = indices_[static_cast<size_t>(faces_[face].vertices_[k])];
+  }
+  std::rotate(v, std::min_element(v, v + count_vertices_of_face),
+              v + count_vertices_of_face);
+  return {v[0], {v[1], v[2]}};
+}
+
+vector<IndexFace> ConflictGraph::SortedFaces() const {
+  vector<IndexFace> res;
+  res.reserve(faces_count_);
+  for (IndexFace face : Faces()) {
+    res.push_back(face);
   }
   sort(res.begin(), res.end());
-  for (auto &re : res) {
-    cout << 3 << " " << re.first << " " << re.second.first << " "
-         << re.second.second << endl;
+  return res;
+}
+
+void WriteFaces(const vector<IndexFace> &faces, FaceWriter &writer) {
+  writer.WriteCount(faces.size());
+  for (auto &face : faces) {
+    writer.WriteFace(face.first, face.second.first, face.second.second);
   }
 }
 
+void ConflictGraph::OutputHill(FaceWriter &writer) {
+  WriteFaces(SortedFaces(), writer);
+}
+
 bool Compare(Point p1, Point p2) {
   return p1.x_ < p2.x_ || (fabs(p1.x_ - p2.x_) < eps && p1.y_ < p2.y_) ||
          (fabs(p1.x_ - p2.x_) < eps && fabs(p1.y_ - p2.y_) < eps &&
           p1.z_ < p2.z_);
 }
 
-int main() {
-  int n;
-  cin >> n;
-  while (n != 0) {
-    --n;
-    int m;
-    cin >> m;
-    vector<Point> points;
-    for (int i = 0; i < m; ++i) {
+vector<Point> FilterHullCandidates(const vector<Point> &ordered_points,
+                                   size_t threads_count) {
+  size_t parts = min(threads_count, ordered_points.size() / min_points_per_thread);
+  if (parts < 2) {
+    return ordered_points;
+  }
+  vector<vector<Point>> candidates(parts);
+  vector<std::thread> workers;
+  for (size_t i = 0; i < parts; ++i) {
+    workers.emplace_back([&ordered_points, &candidates, i, parts]() {
+      vector<Point> part(
+          ordered_points.begin() +
+              static_cast<long>(ordered_points.size() * i / parts),
+          ordered_points.begin() +
+              static_cast<long>(ordered_points.size() * (i + 1) / parts));
+      ConflictGraph graph;
+      candidates[i] = graph.Build(part) ? graph.HullVertices() : part;
+      sort(candidates[i].begin(), candidates[i].end(), Compare);
+    });
+  }
+  vector<Point> result;
+  for (size_t i = 0; i < parts; ++i) {
+    workers[i].join();
+    result.insert(result.end(), candidates[i].begin(), candidates[i].end());
+  }
+  return result;
+}
+
+double CullInteriorPoints(vector<Point> &points) {
+  if (points.size() < min_points_for_culling) {
+    return 0.0;
+  }
+  vector<double> xs(points.size());
+  vector<double> ys(points.size());
+  vector<double> zs(points.size());
+  double radius = 0;
+  for (size_t i = 0; i < points.size(); ++i) {
+    xs[i] = points[i].x_;
+    ys[i] = points[i].y_;
+    zs[i] = points[i].z_;
+    radius = max(radius, max(fabs(xs[i]), max(fabs(ys[i]), fabs(zs[i]))));
+  }
+  vector<Point> extremes;
+  for (int dx = -1; dx <= 1; ++dx) {
+    for (int dy = -1; dy <= 1; ++dy) {
+      for (int dz = -1; dz <= 1; ++dz) {
+        if (dx == 0 && dy == 0 && dz == 0) {
+          continue;
+        }
+        size_t best = 0;
+        double best_value = std::numeric_limits<double>::lowest();
+        for (size_t i = 0; i < points.size(); ++i) {
+          double value = dx * xs[i] + dy * ys[i] + dz * zs[i];
+          if (value > best_value) {
+            best_value = value;
+            best = i;
+          }
+        }
+        bool is_new = true;
+        for (const Point &p : extremes) {
+          is_new = is_new && p.index_ != points[best].index_;
+        }
+        if (is_new) {
+          extremes.push_back(points[best]);
+        }
+      }
+    }
+  }
+  sort(extremes.begin(), extremes.end(), Compare);
+  if (extremes.size() < count_faces_of_tetrahedron ||
+      Orient3d(extremes[0], extremes[1], extremes[2], extremes[3]) == 0) {
+    return 0.0;
+  }
+  ConflictGraph polytope(extremes);
+  auto vertex = [&extremes](size_t index) {
+    for (const Point &p : extremes) {
+      if (p.index_ == index) {
+        return p;
+      }
+    }
+    return extremes[0];
+  };
+  vector<char> is_inside(points.size(), 1);
+  for (IndexFace face : polytope.Faces()) {
+    Point a = vertex(face.first);
+    Point b = vertex(face.second.first);
+    Point c = vertex(face.second.second);
+    Point u = b - a;
+    Point v = c - a;
+    double nx = u.y_ * v.z_ - u.z_ * v.y_;
+    double ny = u.z_ * v.x_ - u.x_ * v.z_;
+    double nz = u.x_ * v.y_ - u.y_ * v.x_;
+    double d = nx * a.x_ + ny * a.y_ + nz * a.z_;
+    double limit = d - culling_margin * ((fabs(nx) + fabs(ny) + fabs(nz)) *
+                                             radius +
+                                         fabs(d));
+    for (size_t i = 0; i < points.size(); ++i) {
+      is_inside[i] &= static_cast<char>(nx * xs[i] + ny * ys[i] +
+                                        nz * zs[i] < limit);
+    }
+  }
+  size_t kept = 0;
+  for (size_t i = 0; i < points.size(); ++i) {
+    if (!is_inside[i]) {
+      points[kept++] = points[i];
+    }
+  }
+  double culled = static_cast<double>(points.size() - kept) /
+                  static_cast<double>(points.size());
+  points.resize(kept);
+  return culled;
+}
+
+class TaskQueue {
+ private:
+  std::deque<size_t> tasks_;
+  std::mutex mutex_;
+
+ public:
+  void Push(size_t task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push_back(task);
+  }
+  bool Pop(size_t &task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty()) {
+      return false;
+    }
+    task = tasks_.back();
+    tasks_.pop_back();
+    return true;
+  }
+  bool Steal(size_t &task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty()) {
+      return false;
+    }
+    task = tasks_.front();
+    tasks_.pop_front();
+    return true;
+  }
+};
+
+template <typename Function>
+void RunWorkStealing(size_t tasks_count, size_t threads_count,
+                     Function function) {
+  threads_count = max(min(threads_count, tasks_count), size_t(1));
+  vector<TaskQueue> queues(threads_count);
+  for (size_t i = tasks_count; i > 0; --i) {
+    queues[(i - 1) % threads_count].Push(i - 1);
+  }
+  auto worker = [&queues, &function, threads_count](size_t id) {
+    size_t task;
+    while (true) {
+      if (queues[id].Pop(task)) {
+        function(id, task);
+        continue;
+      }
+      bool stolen = false;
+      for (size_t k = 1; k < threads_count && !stolen; ++k) {
+        stolen = queues[(id + k) % threads_count].Steal(task);
+      }
+      if (!stolen) {
+        return;
+      }
+      function(id, task);
+    }
+  };
+  vector<std::thread> workers;
+  for (size_t id = 1; id < threads_count; ++id) {
+    workers.emplace_back(worker, id);
+  }
+  worker(0);
+  for (std::thread &t : workers) {
+    t.join();
+  }
+}
+
+vector<vector<IndexFace>> BuildHulls(vector<vector<Point>> &point_sets,
+                                     size_t threads_count,
+                                     InsertionOrder order,
+                                     vector<size_t> &culled) {
+  vector<vector<IndexFace>> hulls(point_sets.size());
+  culled.assign(point_sets.size(), 0);
+  threads_count = max(min(threads_count, point_sets.size()), size_t(1));
+  vector<ConflictGraph> arenas(threads_count);
+  RunWorkStealing(point_sets.size(), threads_count,
+                  [&point_sets, &hulls, &arenas, &culled, order](
+                      size_t worker, size_t task) {
+                    vector<Point> &points = point_sets[task];
+                    size_t size = points.size();
+                    CullInteriorPoints(points);
+                    culled[task] = size - points.size();
+                    sort(points.begin(), points.end(), Compare);
+                    arenas[worker].Build(points, order);
+                    hulls[task] = arenas[worker].SortedFaces();
+                  });
+  return hulls;
+}
+
+int main(int argc, char **argv) {
+  Format input_format = Format::Text;
+  Format output_format = Format::Text;
+  bool report_culling = false;
+  InsertionOrder order = InsertionOrder::SortedByX;
+  size_t threads_count = std::thread::hardware_concurrency();
+  for (int i = 1; i < argc; ++i) {
+    string arg = argv[i];
+    if (arg == "--binary-input") {
+      input_format = Format::Binary;
+    } else if (arg == "--binary-output") {
+      output_format = Format::Binary;
+    } else if (arg == "--report-culling") {
+      report_culling = true;
+    } else if (arg == "--randomized") {
+      order = InsertionOrder::Randomized;
+    } else if (arg == "--threads" && i + 1 < argc) {
+      threads_count = static_cast<size_t>(strtoul(argv[++i], nullptr, 10));
+    }
+  }
+  PointReader reader(stdin, input_format);
+  FaceWriter writer(stdout, output_format);
+  size_t n = 0;
+  if (!reader.ReadCount(n)) {
+    fprintf(stderr, "failed to read the number of tests\n");
+    return 1;
+  }
+  vector<vector<Point>> point_sets;
+  for (size_t test = 0; test < n; ++test) {
+    size_t m = 0;
+    if (!reader.ReadCount(m)) {
+      fprintf(stderr, "failed to read the size of test %zu\n", test + 1);
+      return 1;
+    }
+    point_sets.emplace_back();
+    vector<Point> &points = point_sets.back();
+    for (size_t i = 0; i < m; ++i) {
       double x;
       double y;
       double z;
-      cin >> x >> y >> z;
+      if (!reader.ReadPoint(x, y, z)) {
+        fprintf(stderr, "failed to read point %zu of test %zu\n", i + 1,
+                test + 1);
+        return 1;
+      }
       points.emplace_back(x, y, z, i);
     }
+  }
+  if (point_sets.size() == 1) {
+    vector<Point> &points = point_sets[0];
+    double culled = CullInteriorPoints(points);
+    if (report_culling) {
+      fprintf(stderr, "culled %.2f%% of points\n", 100 * culled);
+    }
     sort(points.begin(), points.end(), Compare);
-    ConflictGraph graph(points);
-    graph.OutputHill();
+    ConflictGraph graph(FilterHullCandidates(points, threads_count), order);
+    graph.OutputHill(writer);
+    if (!writer.Flush()) {
+      fprintf(stderr, "failed to write the faces\n");
+      return 1;
+    }
+    return 0;
+  }
+  size_t total = 0;
+  for (const vector<Point> &points : point_sets) {
+    total += points.size();
+  }
+  vector<size_t> culled;
+  for (const vector<IndexFace> &faces :
+       BuildHulls(point_sets, threads_count, order, culled)) {
+    WriteFaces(faces, writer);
+  }
+  if (report_culling) {
+    size_t culled_total = 0;
+    for (size_t count : culled) {
+      culled_total += count;
+    }
+    fprintf(stderr, "culled %.2f%% of points\n",
+            total == 0 ? 0.0
+                       : 100 * static_cast<double>(culled_total) /
+                             static_cast<double>(total));
+  }
+  if (!writer.Flush()) {
+    fprintf(stderr, "failed to write the faces\n");
+    return 1;
   }
   return 0;
-}
\ No newline at end of file
+}
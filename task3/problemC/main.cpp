@@ -1,20 +1,31 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
+#include <thread>
+#include <utility>
 #include <vector>
 
+#include "../predicates.h"
+
 using std::cin;
 using std::cout;
 using std::endl;
+using std::max;
+using std::min;
+using std::pair;
 using std::vector;
 
-const double eps = 1e-8;
+const double gjk_tolerance = 1e-12;
+const size_t pairs_per_task = 256;
 
 struct Point {
   double x_;
   double y_;
+  Point() : x_(0), y_(0) {}
   Point(double x, double y) : x_(x), y_(y) {}
   bool operator<(const Point &p) const {
-    return this->y_ < p.y_ || (fabs(this->y_ - p.y_) < eps && this->x_ < p.x_);
+    return this->y_ < p.y_ || (this->y_ == p.y_ && this->x_ < p.x_);
   }
   Point operator-(const Point &p) const {
     return {this->x_ - p.x_, this->y_ - p.y_};
@@ -22,70 +33,86 @@ struct Point {
   Point operator+(const Point &p) const {
     return {this->x_ + p.x_, this->y_ + p.y_};
   }
+  int HalfPlane() const { return y_ < 0 || (y_ == 0 && x_ < 0) ? 1 : 0; }
   bool IsRotateLess(const Point &p) const;
 };
 
 bool Point::IsRotateLess(const Point &p) const {
-  if (this->y_ > 0 && p.y_ < 0) {
-    return true;
-  }
-  if (this->y_ < 0 && p.y_ > 0) {
-    return false;
-  }
-  if (fabs(this->y_) < eps && fabs(y_) < eps) {
-    if (this->x_ >= 0 && p.x_ < 0) {
-      return true;
-    }
-    if (this->x_ <= 0 && p.x_ > 0) {
-      return false;
-    }
+  if (HalfPlane() != p.HalfPlane()) {
+    return HalfPlane() < p.HalfPlane();
   }
-  double vec_mult = this->x_ * p.y_ - this->y_ * p.x_;
-  if (fabs(vec_mult) < eps) {
-    return false;
-  }
-  return vec_mult > 0;
+  return Orient2d(this->x_, this->y_, p.x_, p.y_, 0, 0) > 0;
 }
 
-void PolygonCyclicShift(vector<Point> &polygon) {
-  Point min_point = polygon[0];
+double Orient2d(const Point &a, const Point &b, const Point &c) {
+  return Orient2d(a.x_, a.y_, b.x_, b.y_, c.x_, c.y_);
+}
+
+size_t LowestVertex(const vector<Point> &polygon) {
   size_t min_index = 0;
-  for (size_t i = 0; i < polygon.size(); ++i) {
-    if (polygon[i] < min_point) {
-      min_point = polygon[i];
+  for (size_t i = 1; i < polygon.size(); ++i) {
+    if (polygon[i] < polygon[min_index]) {
       min_index = i;
     }
   }
-  vector<Point> copy_polygon = polygon;
-  const size_t size = polygon.size();
-  for (size_t i = 0; i < size; ++i) {
-    polygon[i] = copy_polygon[(min_index + size - i) % size];
-  }
-  polygon.push_back(polygon[0]);
-  polygon.push_back(polygon[1]);
+  return min_index;
 }
 
-vector<Point> MinkovskiSum(const vector<Point> &polygon1,
-                           const vector<Point> &polygon2) {
-  vector<Point> result;
+const Point &CounterclockwiseVertex(const vector<Point> &polygon, size_t start,
+                                    size_t k) {
+  size_t size = polygon.size();
+  k = k == size ? 0 : k;
+  return polygon[start >= k ? start - k : start + size - k];
+}
+
+template <typename Visitor>
+bool WalkMinkovskiSum(const vector<Point> &polygon1,
+                      const vector<Point> &polygon2, Visitor visit) {
+  size_t n = polygon1.size();
+  size_t m = polygon2.size();
+  size_t start1 = LowestVertex(polygon1);
+  size_t start2 = LowestVertex(polygon2);
   size_t i = 0;
   size_t j = 0;
-  Point point1(0, 0);
-  Point point2(0, 0);
-  while ((i < polygon1.size() - 1 || j < polygon2.size() - 1) &&
-         i + j < polygon1.size() + polygon2.size() - 3) {
-    result.push_back(polygon1[i] + polygon2[j]);
-    point1 = polygon1[i + 1] - polygon1[i];
-    point2 = polygon2[j + 1] - polygon2[j];
-    if (point1.IsRotateLess(point2)) {
+  Point current = polygon1[start1] + polygon2[start2];
+  while (i < n || j < m) {
+    if (j == m) {
       ++i;
-    } else if (point2.IsRotateLess(point1)) {
+    } else if (i == n) {
       ++j;
     } else {
-      ++i;
-      ++j;
+      Point edge1 = CounterclockwiseVertex(polygon1, start1, i + 1) -
+                    CounterclockwiseVertex(polygon1, start1, i);
+      Point edge2 = CounterclockwiseVertex(polygon2, start2, j + 1) -
+                    CounterclockwiseVertex(polygon2, start2, j);
+      if (edge1.IsRotateLess(edge2)) {
+        ++i;
+      } else if (edge2.IsRotateLess(edge1)) {
+        ++j;
+      } else {
+        ++i;
+        ++j;
+      }
+    }
+    Point next = CounterclockwiseVertex(polygon1, start1, i) +
+                 CounterclockwiseVertex(polygon2, start2, j);
+    if (!visit(current, next)) {
+      return false;
     }
+    current = next;
   }
+  return true;
+}
+
+vector<Point> MinkovskiSum(const vector<Point> &polygon1,
+                           const vector<Point> &polygon2) {
+  vector<Point> result;
+  result.reserve(polygon1.size() + polygon2.size());
+  WalkMinkovskiSum(polygon1, polygon2, [&result](const Point &current,
+                                                 const Point &) {
+    result.push_back(current);
+    return true;
+  });
   return result;
 }
 
@@ -93,22 +120,443 @@ bool IsDifferentSigns(double x, double y) {
   return (x <= 0 && y >= 0) || (x >= 0 && y <= 0);
 }
 
+bool IsZeroPointLeftOf(const Point &begin, const Point &end) {
+  double vec_mult = Orient2d(begin.x_, begin.y_, end.x_, end.y_, 0, 0);
+  if (vec_mult == 0) {
+    return IsDifferentSigns(begin.x_, end.x_) &&
+           IsDifferentSigns(begin.y_, end.y_);
+  }
+  return vec_mult > 0;
+}
+
 bool IsZeroPointInPolygon(const vector<Point> &polygon) {
-  for (size_t i = 0; i < polygon.size() - 1; ++i) {
-    double vec_mult =
-        polygon[i].x_ * polygon[i + 1].y_ - polygon[i].y_ * polygon[i + 1].x_;
-    if (fabs(vec_mult) < eps) {
-      if (!(IsDifferentSigns(polygon[i].x_, polygon[i + 1].x_) &&
-            IsDifferentSigns(polygon[i].y_, polygon[i + 1].y_))) {
-        return false;
-      }
-    } else if (vec_mult < 0) {
+  for (size_t i = 0; i < polygon.size(); ++i) {
+    if (!IsZeroPointLeftOf(polygon[i], polygon[(i + 1) % polygon.size()])) {
       return false;
     }
   }
   return true;
 }
 
+bool IsZeroPointInMinkovskiSum(const vector<Point> &polygon1,
+                               const vector<Point> &polygon2) {
+  return WalkMinkovskiSum(polygon1, polygon2, IsZeroPointLeftOf);
+}
+
+bool IsOnSegment(const Point &begin, const Point &end, const Point &p) {
+  return IsDifferentSigns(begin.x_ - p.x_, end.x_ - p.x_) &&
+         IsDifferentSigns(begin.y_ - p.y_, end.y_ - p.y_);
+}
+
+vector<Point> Negate(const vector<Point> &polygon) {
+  vector<Point> result;
+  result.reserve(polygon.size());
+  for (const Point &p : polygon) {
+    result.emplace_back(-p.x_, -p.y_);
+  }
+  return result;
+}
+
+// Overwrites negated with the negated polygons, reusing its storage.
+void NegateAll(const vector<vector<Point>> &polygons,
+               vector<vector<Point>> &negated) {
+  negated.resize(polygons.size());
+  for (size_t shape = 0; shape < polygons.size(); ++shape) {
+    negated[shape].clear();
+    for (const Point &p : polygons[shape]) {
+      negated[shape].emplace_back(-p.x_, -p.y_);
+    }
+  }
+}
+
+// Stores polygon1 - polygon2 once, so that the two polygons can be tested
+// for intersection under any pair of translations in logarithmic time. Both
+// polygons are given as they are; polygon2 is negated here.
+class PreparedMinkovskiSum {
+ private:
+  vector<Point> vertices_;
+
+ public:
+  PreparedMinkovskiSum(const vector<Point> &polygon1,
+                       const vector<Point> &polygon2)
+      : vertices_(MinkovskiSum(polygon1, Negate(polygon2))) {}
+  bool Contains(const Point &p) const;
+  bool IsIntersecting(const Point &shift1, const Point &shift2) const {
+    return Contains(shift2 - shift1);
+  }
+};
+
+bool PreparedMinkovskiSum::Contains(const Point &p) const {
+  const Point &origin = vertices_[0];
+  size_t size = vertices_.size();
+  double first = Orient2d(origin, vertices_[1], p);
+  double last = Orient2d(origin, vertices_[size - 1], p);
+  if (first < 0 || last > 0) {
+    return false;
+  }
+  if (first == 0) {
+    return IsOnSegment(origin, vertices_[1], p);
+  }
+  if (last == 0) {
+    return IsOnSegment(origin, vertices_[size - 1], p);
+  }
+  size_t left = 1;
+  size_t right = size - 1;
+  while (right - left > 1) {
+    size_t middle = left + (right - left) / 2;
+    if (Orient2d(origin, vertices_[middle], p) > 0) {
+      left = middle;
+    } else {
+      right = middle;
+    }
+  }
+  return Orient2d(vertices_[left], vertices_[right], p) >= 0;
+}
+
+double Dot(const Point &a, const Point &b) { return a.x_ * b.x_ + a.y_ * b.y_; }
+
+size_t SupportVertex(const vector<Point> &polygon, const Point &direction,
+                     size_t hint) {
+  size_t size = polygon.size();
+  size_t best = hint < size ? hint : 0;
+  double best_dot = Dot(polygon[best], direction);
+  bool is_improved = true;
+  while (is_improved) {
+    is_improved = false;
+    for (size_t next : {best + 1 == size ? 0 : best + 1,
+                        best == 0 ? size - 1 : best - 1}) {
+      double next_dot = Dot(polygon[next], direction);
+      if (next_dot > best_dot) {
+        best = next;
+        best_dot = next_dot;
+        is_improved = true;
+        break;
+      }
+    }
+  }
+  return best;
+}
+
+struct SimplexVertex {
+  Point point_;
+  size_t index1_;
+  size_t index2_;
+};
+
+// Simplex of the last query of a pair; its vertex indices seed the next one.
+struct GjkCache {
+  SimplexVertex simplex_[3];
+  size_t size_ = 0;
+};
+
+// offset_ is the translation of the first polygon that brings the polygons
+// into touching contact: normal_ * distance_, where distance_ is negative
+// when they overlap and normal_ points from the first polygon to the second.
+struct Contact {
+  bool is_intersecting_;
+  double distance_;
+  Point normal_;
+  Point offset_;
+};
+
+Point ClosestToZeroPoint(const Point &a, const Point &b, double &t) {
+  Point edge = b - a;
+  double length = Dot(edge, edge);
+  t = length > 0 ? std::min(std::max(-Dot(a, edge) / length, 0.0), 1.0) : 0;
+  return {a.x_ + t * edge.x_, a.y_ + t * edge.y_};
+}
+
+Point ReduceSimplex(SimplexVertex *simplex, size_t &size) {
+  if (size == 1) {
+    return simplex[0].point_;
+  }
+  if (size == 2) {
+    double t;
+    Point closest = ClosestToZeroPoint(simplex[0].point_, simplex[1].point_, t);
+    if (t == 1) {
+      simplex[0] = simplex[1];
+    }
+    size = t == 0 || t == 1 ? 1 : 2;
+    return closest;
+  }
+  const Point zero;
+  double orientations[3];
+  size_t best_edge = 0;
+  double best_distance = 0;
+  for (size_t i = 0; i < 3; ++i) {
+    const Point &begin = simplex[i].point_;
+    const Point &end = simplex[i == 2 ? 0 : i + 1].point_;
+    orientations[i] = Orient2d(begin, end, zero);
+    double t;
+    Point closest = ClosestToZeroPoint(begin, end, t);
+    double distance = Dot(closest, closest);
+    if (i == 0 || distance < best_distance) {
+      best_edge = i;
+      best_distance = distance;
+    }
+  }
+  if ((orientations[0] >= 0 && orientations[1] >= 0 && orientations[2] >= 0) ||
+      (orientations[0] <= 0 && orientations[1] <= 0 && orientations[2] <= 0)) {
+    return zero;
+  }
+  SimplexVertex begin = simplex[best_edge];
+  SimplexVertex end = simplex[best_edge == 2 ? 0 : best_edge + 1];
+  simplex[0] = begin;
+  simplex[1] = end;
+  size = 2;
+  return ReduceSimplex(simplex, size);
+}
+
+// Depth and outward normal of the edge of polygon1 + negated2 nearest to the
+// origin, which is the exact penetration of two overlapping polygons when
+// negated2 is the second one negated.
+double FindPenetration(const vector<Point> &polygon1,
+                       const vector<Point> &negated2, Point &normal) {
+  double depth = 0;
+  bool is_first = true;
+  WalkMinkovskiSum(polygon1, negated2, [&](const Point &begin,
+                                           const Point &end) {
+    Point edge = end - begin;
+    double length = sqrt(Dot(edge, edge));
+    if (length == 0) {
+      return true;
+    }
+    Point edge_normal(edge.y_ / length, -edge.x_ / length);
+    double distance = Dot(edge_normal, begin);
+    if (is_first || distance < depth) {
+      depth = distance;
+      normal = edge_normal;
+      is_first = false;
+    }
+    return true;
+  });
+  return std::max(depth, 0.0);
+}
+
+Contact FindContact(const vector<Point> &polygon1,
+                    const vector<Point> &polygon2,
+                    const vector<Point> &negated2, GjkCache &cache) {
+  SimplexVertex *simplex = cache.simplex_;
+  size_t &size = cache.size_;
+  for (size_t i = 0; i < size; ++i) {
+    if (simplex[i].index1_ >= polygon1.size() ||
+        simplex[i].index2_ >= polygon2.size()) {
+      size = 0;
+    }
+  }
+  if (size == 0) {
+    simplex[0] = {Point(), 0, 0};
+    size = 1;
+  }
+  for (size_t i = 0; i < size; ++i) {
+    simplex[i].point_ =
+        polygon1[simplex[i].index1_] - polygon2[simplex[i].index2_];
+  }
+  size_t max_iterations = polygon1.size() + polygon2.size() + 3;
+  Point closest;
+  double closest_norm = 0;
+  bool is_intersecting = false;
+  for (size_t iteration = 0; iteration < max_iterations; ++iteration) {
+    closest = ReduceSimplex(simplex, size);
+    closest_norm = Dot(closest, closest);
+    if (size == 3 || closest_norm == 0) {
+      is_intersecting = true;
+      break;
+    }
+    const SimplexVertex &last = simplex[size - 1];
+    SimplexVertex support;
+    support.index1_ = SupportVertex(polygon1, Point(-closest.x_, -closest.y_),
+                                    last.index1_);
+    support.index2_ = SupportVertex(polygon2, closest, last.index2_);
+    support.point_ = polygon1[support.index1_] - polygon2[support.index2_];
+    bool is_known = false;
+    for (size_t i = 0; i < size; ++i) {
+      is_known = is_known || (simplex[i].index1_ == support.index1_ &&
+                              simplex[i].index2_ == support.index2_);
+    }
+    if (is_known || closest_norm - Dot(closest, support.point_) <=
+                        gjk_tolerance * closest_norm) {
+      break;
+    }
+    simplex[size++] = support;
+  }
+  Contact contact;
+  contact.is_intersecting_ = is_intersecting;
+  if (is_intersecting) {
+    contact.distance_ = -FindPenetration(polygon1, negated2, contact.normal_);
+  } else {
+    contact.distance_ = sqrt(closest_norm);
+    contact.normal_ = Point(-closest.x_ / contact.distance_,
+                            -closest.y_ / contact.distance_);
+  }
+  contact.offset_ = Point(contact.normal_.x_ * contact.distance_,
+                          contact.normal_.y_ * contact.distance_);
+  return contact;
+}
+
+struct CachedPair {
+  pair<size_t, size_t> shapes_;
+  GjkCache cache_;
+};
+
+// Keeps the GJK simplex of every pair queried in the previous frame, sorted
+// by pair, so that a pair list in the same order is matched by a linear scan.
+class NarrowPhase {
+ private:
+  vector<CachedPair> caches_;
+  vector<vector<Point>> negated_;
+
+ public:
+  vector<Contact> Collide(const vector<vector<Point>> &polygons,
+                          const vector<pair<size_t, size_t>> &pairs);
+};
+
+vector<Contact> NarrowPhase::Collide(
+    const vector<vector<Point>> &polygons,
+    const vector<pair<size_t, size_t>> &pairs) {
+  auto is_less = [](const CachedPair &a, const CachedPair &b) {
+    return a.shapes_ < b.shapes_;
+  };
+  NegateAll(polygons, negated_);
+  vector<CachedPair> caches(pairs.size());
+  vector<Contact> contacts;
+  contacts.reserve(pairs.size());
+  auto previous = caches_.begin();
+  for (size_t i = 0; i < pairs.size(); ++i) {
+    caches[i].shapes_ = pairs[i];
+    if (previous == caches_.end() || previous->shapes_ != pairs[i]) {
+      previous = std::lower_bound(caches_.begin(), caches_.end(), caches[i],
+                                  is_less);
+    }
+    if (previous != caches_.end() && previous->shapes_ == pairs[i]) {
+      caches[i].cache_ = previous->cache_;
+      ++previous;
+    }
+    contacts.push_back(FindContact(polygons[pairs[i].first],
+                                   polygons[pairs[i].second],
+                                   negated_[pairs[i].second],
+                                   caches[i].cache_));
+  }
+  if (!std::is_sorted(caches.begin(), caches.end(), is_less)) {
+    std::sort(caches.begin(), caches.end(), is_less);
+  }
+  caches_.swap(caches);
+  return contacts;
+}
+
+template <typename Function>
+void RunParallel(size_t tasks_count, size_t threads_count, Function function) {
+  threads_count = max(min(threads_count, tasks_count), size_t(1));
+  std::atomic<size_t> next_task(0);
+  auto worker = [&next_task, &function, tasks_count]() {
+    for (size_t task = next_task++; task < tasks_count; task = next_task++) {
+      function(task);
+    }
+  };
+  vector<std::thread> workers;
+  for (size_t id = 1; id < threads_count; ++id) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread &t : workers) {
+    t.join();
+  }
+}
+
+struct Bounds {
+  double min_x_;
+  double max_x_;
+  double min_y_;
+  double max_y_;
+  size_t shape_;
+};
+
+Bounds FindBounds(const vector<Point> &polygon, size_t shape) {
+  Bounds bounds{polygon[0].x_, polygon[0].x_, polygon[0].y_, polygon[0].y_,
+                shape};
+  for (const Point &p : polygon) {
+    bounds.min_x_ = min(bounds.min_x_, p.x_);
+    bounds.max_x_ = max(bounds.max_x_, p.x_);
+    bounds.min_y_ = min(bounds.min_y_, p.y_);
+    bounds.max_y_ = max(bounds.max_y_, p.y_);
+  }
+  return bounds;
+}
+
+// Bounding boxes sorted by min_x_. Between frames the order barely changes,
+// so Update restores it by insertion sort.
+class SweepAndPrune {
+ private:
+  vector<Bounds> sorted_;
+
+ public:
+  void Update(const vector<vector<Point>> &polygons);
+  vector<pair<size_t, size_t>> CandidatePairs() const;
+};
+
+void SweepAndPrune::Update(const vector<vector<Point>> &polygons) {
+  size_t known = sorted_.size();
+  size_t kept = 0;
+  for (const Bounds &bounds : sorted_) {
+    if (bounds.shape_ < polygons.size()) {
+      sorted_[kept] = FindBounds(polygons[bounds.shape_], bounds.shape_);
+      ++kept;
+    }
+  }
+  sorted_.resize(kept);
+  for (size_t shape = known; shape < polygons.size(); ++shape) {
+    sorted_.push_back(FindBounds(polygons[shape], shape));
+  }
+  if (sorted_.size() > 2 * kept) {
+    std::sort(sorted_.begin(), sorted_.end(),
+              [](const Bounds &a, const Bounds &b) {
+                return a.min_x_ < b.min_x_;
+              });
+    return;
+  }
+  for (size_t i = 1; i < sorted_.size(); ++i) {
+    Bounds bounds = sorted_[i];
+    size_t j = i;
+    for (; j > 0 && bounds.min_x_ < sorted_[j - 1].min_x_; --j) {
+      sorted_[j] = sorted_[j - 1];
+    }
+    sorted_[j] = bounds;
+  }
+}
+
+vector<pair<size_t, size_t>> SweepAndPrune::CandidatePairs() const {
+  vector<pair<size_t, size_t>> pairs;
+  for (size_t i = 0; i < sorted_.size(); ++i) {
+    const Bounds &a = sorted_[i];
+    for (size_t j = i + 1; j < sorted_.size() && sorted_[j].min_x_ <= a.max_x_;
+         ++j) {
+      const Bounds &b = sorted_[j];
+      if (b.min_y_ <= a.max_y_ && a.min_y_ <= b.max_y_) {
+        pairs.emplace_back(min(a.shape_, b.shape_), max(a.shape_, b.shape_));
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  return pairs;
+}
+
+vector<char> FindIntersectingPairs(const vector<vector<Point>> &polygons,
+                                   const vector<pair<size_t, size_t>> &pairs,
+                                   size_t threads_count) {
+  vector<vector<Point>> negated;
+  NegateAll(polygons, negated);
+  vector<char> is_intersecting(pairs.size());
+  size_t tasks_count = (pairs.size() + pairs_per_task - 1) / pairs_per_task;
+  RunParallel(tasks_count, threads_count, [&](size_t task) {
+    size_t end = min(pairs.size(), (task + 1) * pairs_per_task);
+    for (size_t i = task * pairs_per_task; i < end; ++i) {
+      is_intersecting[i] = IsZeroPointInMinkovskiSum(
+          polygons[pairs[i].first], negated[pairs[i].second]);
+    }
+  });
+  return is_intersecting;
+}
+
 int main() {
   int n;
   int m;
@@ -121,7 +569,6 @@ int main() {
     cin >> x >> y;
     polygon1.emplace_back(x, y);
   }
-  PolygonCyclicShift(polygon1);
   cin >> m;
   for (int i = 0; i < m; ++i) {
     double x;
@@ -129,9 +576,7 @@ int main() {
     cin >> x >> y;
     polygon2.emplace_back(-x, -y);
   }
-  PolygonCyclicShift(polygon2);
-  vector<Point> mink = MinkovskiSum(polygon1, polygon2);
-  if (IsZeroPointInPolygon(mink)) {
+  if (IsZeroPointInMinkovskiSum(polygon1, polygon2)) {
     cout << "YES" << endl;
   } else {
     cout << "NO" << endl;
@@ -1,483 +1,904 @@
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
-#include <queue>
-#include <stack>
-#include <unordered_map>
+#include <limits>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
-using std::cin;
+#include "../predicates.h"
+
 using std::cout;
 using std::endl;
-using std::fabs;
-using std::hash;
 using std::max;
 using std::min;
+using std::numeric_limits;
 using std::pair;
-using std::queue;
 using std::sort;
-using std::stack;
-using std::unordered_map;
+using std::string;
+using std::swap;
 using std::vector;
 
-const double inf = 1e9;
-const double eps = 1e-9;
-const size_t count_faces_of_tetrahedron = 4;
+const size_t min_points_for_cells = 4;
 const size_t precision = 12;
+const size_t min_sites_per_strip = 1 << 14;
+const size_t read_chunk_size = 1 << 16;
+const int32_t no_edge = -1;
+const int32_t no_face = -1;
+const double unbounded_area = numeric_limits<double>::infinity();
+const size_t no_point = numeric_limits<size_t>::max();
+const size_t sites_per_seed = 2;
+const double morton_scale = 65535;
 
 struct Point {
   double x_;
   double y_;
-  double z_;
   size_t index_;
-  Point() : x_(inf), y_(inf), z_(inf), index_(0) {}
-  Point(double x, double y, double z, size_t index)
-      : x_(x), y_(y), z_(z), index_(index) {}
-  bool operator<(const Point &p) const { return index_ < p.index_; }
-  bool operator==(const Point &p) const {
-    return fabs(x_ - p.x_) < eps && fabs(y_ - p.y_) < eps &&
-           fabs(z_ - p.z_) < eps;
-  }
-  Point operator-(const Point &p) const {
-    return {x_ - p.x_, y_ - p.y_, z_ - p.z_, index_ - p.index_};
-  }
-  Point operator+(const Point &p) const {
-    return {x_ + p.x_, y_ + p.y_, z_ + p.z_, index_ + p.index_};
-  }
-  Point operator-() const { return {-x_, -y_, -z_, 0}; }
-  Point operator=(Point p) {
-    x_ = p.x_;
-    y_ = p.y_;
-    z_ = p.z_;
-    index_ = p.index_;
-    return *this;
+  Point() : x_(0), y_(0), index_(0) {}
+  Point(double x, double y, size_t index) : x_(x), y_(y), index_(index) {}
+};
+
+template <typename Function>
+void RunParallel(size_t tasks_count, size_t threads_count, Function function) {
+  threads_count = max(min(threads_count, tasks_count), size_t(1));
+  std::atomic<size_t> next_task(0);
+  auto worker = [&next_task, &function, tasks_count]() {
+    for (size_t task = next_task++; task < tasks_count; task = next_task++) {
+      function(task);
+    }
+  };
+  vector<std::thread> workers;
+  for (size_t id = 1; id < threads_count; ++id) {
+    workers.emplace_back(worker);
+  }
+  worker();
+  for (std::thread &t : workers) {
+    t.join();
+  }
+}
+
+template <typename Compare>
+void ParallelSort(vector<size_t> &values, Compare compare,
+                  size_t threads_count) {
+  size_t chunks = 1;
+  while (chunks * 2 <= threads_count &&
+         values.size() / (chunks * 2) >= min_sites_per_strip) {
+    chunks *= 2;
+  }
+  auto bound = [&values, chunks](size_t chunk) {
+    return values.begin() +
+           static_cast<std::ptrdiff_t>(values.size() * chunk / chunks);
+  };
+  RunParallel(chunks, threads_count, [&bound, &compare](size_t chunk) {
+    sort(bound(chunk), bound(chunk + 1), compare);
+  });
+  for (size_t width = 1; width < chunks; width *= 2) {
+    RunParallel(chunks / (2 * width), threads_count,
+                [&bound, &compare, width](size_t pair) {
+                  size_t left = pair * 2 * width;
+                  std::inplace_merge(bound(left), bound(left + width),
+                                     bound(left + 2 * width), compare);
+                });
   }
+}
+
+struct EdgePool {
+  vector<int32_t> free_edges_;
+  int32_t next_edge_ = 0;
+  int32_t end_edge_ = 0;
 };
 
-struct OrientedSegment {
-  Point end1_;
-  Point end2_;
-  OrientedSegment() = default;
-  OrientedSegment(Point end1, Point end2) : end1_(end1), end2_(end2) {}
-  OrientedSegment operator-() const { return {end2_, end1_}; }
+struct VoronoiDiagram {
+  vector<double> vertex_xs_;
+  vector<double> vertex_ys_;
+  vector<int32_t> cell_offsets_;
+  vector<int32_t> cell_vertices_;
+  vector<char> is_bounded_;
+  vector<double> areas_;
+
+  size_t CellsCount() const { return is_bounded_.size(); }
+  size_t CellSize(size_t cell) const {
+    return static_cast<size_t>(cell_offsets_[cell + 1] - cell_offsets_[cell]);
+  }
 };
 
-struct Triangle {
-  Point v1_;
-  Point v2_;
-  Point v3_;
-  size_t neighbour1_;
-  size_t neighbour2_;
-  size_t neighbour3_;
-  OrientedSegment intersect_neighbour1_;
-  OrientedSegment intersect_neighbour2_;
-  OrientedSegment intersect_neighbour3_;
-
-  Triangle()
-      : neighbour1_(static_cast<size_t>(inf)),
-        neighbour2_(static_cast<size_t>(inf)),
-        neighbour3_(static_cast<size_t>(inf)){};
-  Triangle(Point v1, Point v2, Point v3)
-      : v1_(v1),
-        v2_(v2),
-        v3_(v3),
-        neighbour1_(static_cast<size_t>(inf)),
-        neighbour2_(static_cast<size_t>(inf)),
-        neighbour3_(static_cast<size_t>(inf)){};
-  bool operator<(const Triangle &tr) const {
-    return v1_ < tr.v1_ || (v1_ == tr.v1_ && v2_ < tr.v2_) ||
-           (v1_ == tr.v1_ && v2_ == tr.v2_ && v3_ < tr.v3_);
-  }
-  bool operator==(const Triangle &tr) const {
-    return v1_ == tr.v1_ && v2_ == tr.v2_ && v3_ == tr.v3_;
-  }
-
-  void SwapNeighbour(size_t old, size_t update);
+class Delaunay {
+ private:
+  vector<double> xs_;
+  vector<double> ys_;
+  vector<int32_t> site_of_point_;
+  vector<int32_t> next_;
+  vector<int32_t> origin_;
+  vector<char> is_alive_;
+  pair<int32_t, int32_t> hull_edges_ = {no_edge, no_edge};
+
+  static int32_t Rot(int32_t e) { return (e & ~3) | ((e + 1) & 3); }
+  static int32_t InvRot(int32_t e) { return (e & ~3) | ((e + 3) & 3); }
+  static int32_t Sym(int32_t e) { return e ^ 2; }
+  int32_t Onext(int32_t e) const { return next_[e]; }
+  int32_t Oprev(int32_t e) const { return Rot(next_[Rot(e)]); }
+  int32_t Lnext(int32_t e) const { return Rot(next_[InvRot(e)]); }
+  int32_t Rprev(int32_t e) const { return next_[Sym(e)]; }
+  int32_t Org(int32_t e) const { return origin_[e]; }
+  int32_t Dest(int32_t e) const { return origin_[Sym(e)]; }
+
+  bool IsCcw(int32_t a, int32_t b, int32_t c) const {
+    return Orient2d(xs_[a], ys_[a], xs_[b], ys_[b], xs_[c], ys_[c]) > 0;
+  }
+  bool IsInCircle(int32_t a, int32_t b, int32_t c, int32_t d) const {
+    return InCircle(xs_[a], ys_[a], xs_[b], ys_[b], xs_[c], ys_[c], xs_[d],
+                    ys_[d]) > 0;
+  }
+  bool IsRightOf(int32_t site, int32_t e) const {
+    return IsCcw(site, Dest(e), Org(e));
+  }
+  bool IsLeftOf(int32_t site, int32_t e) const {
+    return IsCcw(site, Org(e), Dest(e));
+  }
+
+  int32_t MakeEdge(int32_t org, int32_t dest, EdgePool &pool);
+  void Splice(int32_t a, int32_t b);
+  int32_t Connect(int32_t a, int32_t b, EdgePool &pool);
+  void DeleteEdge(int32_t e, EdgePool &pool);
+  pair<int32_t, int32_t> Triangulate(int32_t begin, int32_t end,
+                                     EdgePool &pool);
+  pair<int32_t, int32_t> Merge(pair<int32_t, int32_t> left,
+                               pair<int32_t, int32_t> right, EdgePool &pool);
+  void TriangulateStrips(size_t strips, size_t threads_count);
+  vector<char> SiteHullFlags() const;
+  vector<int32_t> LabelTriangles(vector<int32_t> &triangle_edges) const;
+  vector<int32_t> MergeCocircular(vector<int32_t> &face_of_edge,
+                                  const vector<int32_t> &triangle_edges) const;
+  vector<int32_t> SiteCell(int32_t e, const vector<int32_t> &face_of_edge,
+                           bool &is_bounded) const;
+
+ public:
+  Delaunay() = default;
+  explicit Delaunay(const vector<Point> &points, size_t threads_count = 1);
+  size_t SitesCount() const { return xs_.size(); }
+  vector<int32_t> Degrees() const;
+  vector<char> HullFlags() const;
+  uint64_t InteriorDegreeSum(size_t threads_count) const;
+  VoronoiDiagram Voronoi() const;
+  double SiteX(int32_t site) const { return xs_[site]; }
+  double SiteY(int32_t site) const { return ys_[site]; }
+  const vector<int32_t> &SitesOfPoints() const { return site_of_point_; }
+  void SiteGraph(vector<int32_t> &offsets, vector<int32_t> &neighbours) const;
 };
 
-void Triangle::SwapNeighbour(size_t old, size_t update) {
-  if (neighbour1_ == old) {
-    neighbour1_ = update;
-  } else if (neighbour2_ == old) {
-    neighbour2_ = update;
+Delaunay::Delaunay(const vector<Point> &points, size_t threads_count) {
+  vector<size_t> order(points.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  ParallelSort(
+      order,
+      [&points](size_t a, size_t b) {
+        return points[a].x_ < points[b].x_ ||
+               (points[a].x_ == points[b].x_ && points[a].y_ < points[b].y_);
+      },
+      threads_count);
+  size_t max_index = 0;
+  for (const Point &p : points) {
+    max_index = std::max(max_index, p.index_ + 1);
+  }
+  site_of_point_.assign(max_index, no_edge);
+  for (size_t i : order) {
+    const Point &p = points[i];
+    if (xs_.empty() || xs_.back() != p.x_ || ys_.back() != p.y_) {
+      xs_.push_back(p.x_);
+      ys_.push_back(p.y_);
+    }
+    site_of_point_[p.index_] = static_cast<int32_t>(xs_.size() - 1);
+  }
+  if (xs_.size() < 2) {
+    return;
+  }
+  size_t strips = 1;
+  while (strips * 2 <= threads_count &&
+         xs_.size() / (strips * 2) >= min_sites_per_strip) {
+    strips *= 2;
+  }
+  if (strips > 1) {
+    TriangulateStrips(strips, threads_count);
+    return;
+  }
+  next_.reserve(12 * xs_.size());
+  origin_.reserve(12 * xs_.size());
+  EdgePool pool;
+  hull_edges_ = Triangulate(0, static_cast<int32_t>(xs_.size()), pool);
+}
+
+void Delaunay::TriangulateStrips(size_t strips, size_t threads_count) {
+  vector<int32_t> site_begin(strips + 1);
+  for (size_t strip = 0; strip <= strips; ++strip) {
+    site_begin[strip] = static_cast<int32_t>(xs_.size() * strip / strips);
+  }
+  vector<Delaunay> parts(strips);
+  vector<EdgePool> pools(strips);
+  RunParallel(strips, threads_count, [&](size_t strip) {
+    Delaunay &part = parts[strip];
+    part.xs_.assign(xs_.begin() + site_begin[strip],
+                    xs_.begin() + site_begin[strip + 1]);
+    part.ys_.assign(ys_.begin() + site_begin[strip],
+                    ys_.begin() + site_begin[strip + 1]);
+    part.next_.reserve(12 * part.xs_.size());
+    part.origin_.reserve(12 * part.xs_.size());
+    part.hull_edges_ = part.Triangulate(
+        0, static_cast<int32_t>(part.xs_.size()), pools[strip]);
+  });
+  vector<int32_t> edge_begin(strips + 1, 0);
+  for (size_t strip = 0; strip < strips; ++strip) {
+    edge_begin[strip + 1] =
+        edge_begin[strip] + static_cast<int32_t>(parts[strip].next_.size());
+  }
+  size_t edges_count = static_cast<size_t>(edge_begin[strips]);
+  next_.resize(edges_count);
+  origin_.resize(edges_count);
+  is_alive_.resize(edges_count / 4);
+  vector<pair<int32_t, int32_t>> hulls(strips);
+  RunParallel(strips, threads_count, [&](size_t strip) {
+    Delaunay &part = parts[strip];
+    int32_t edge_shift = edge_begin[strip];
+    int32_t site_shift = site_begin[strip];
+    for (size_t e = 0; e < part.next_.size(); ++e) {
+      size_t target = static_cast<size_t>(edge_shift) + e;
+      next_[target] = part.next_[e] + edge_shift;
+      origin_[target] =
+          part.origin_[e] == no_edge ? no_edge : part.origin_[e] + site_shift;
+    }
+    std::copy(part.is_alive_.begin(), part.is_alive_.end(),
+              is_alive_.begin() + edge_shift / 4);
+    for (int32_t &e : pools[strip].free_edges_) {
+      e += edge_shift;
+    }
+    hulls[strip] = {part.hull_edges_.first + edge_shift,
+                    part.hull_edges_.second + edge_shift};
+    part = Delaunay();
+  });
+  for (size_t width = 1; width < strips; width *= 2) {
+    size_t size = next_.size();
+    for (size_t left = 0; left < strips; left += 2 * width) {
+      EdgePool &pool = pools[left];
+      EdgePool &other = pools[left + width];
+      pool.free_edges_.insert(pool.free_edges_.end(),
+                              other.free_edges_.begin(),
+                              other.free_edges_.end());
+      other = EdgePool();
+      size_t connects = static_cast<size_t>(site_begin[left + 2 * width] -
+                                            site_begin[left]);
+      pool.next_edge_ = static_cast<int32_t>(size);
+      if (connects > pool.free_edges_.size()) {
+        size += 4 * (connects - pool.free_edges_.size());
+      }
+      pool.end_edge_ = static_cast<int32_t>(size);
+    }
+    next_.resize(size);
+    origin_.resize(size, no_edge);
+    is_alive_.resize(size / 4, 0);
+    RunParallel(strips / (2 * width), threads_count, [&](size_t pair) {
+      size_t left = pair * 2 * width;
+      EdgePool &pool = pools[left];
+      hulls[left] = Merge(hulls[left], hulls[left + width], pool);
+      for (; pool.next_edge_ < pool.end_edge_; pool.next_edge_ += 4) {
+        pool.free_edges_.push_back(pool.next_edge_);
+      }
+    });
+  }
+  hull_edges_ = hulls[0];
+}
+
+int32_t Delaunay::MakeEdge(int32_t org, int32_t dest, EdgePool &pool) {
+  int32_t e;
+  if (!pool.free_edges_.empty()) {
+    e = pool.free_edges_.back();
+    pool.free_edges_.pop_back();
+  } else if (pool.next_edge_ < pool.end_edge_) {
+    e = pool.next_edge_;
+    pool.next_edge_ += 4;
   } else {
-    neighbour3_ = update;
+    e = static_cast<int32_t>(next_.size());
+    next_.insert(next_.end(), {e, e + 3, e + 2, e + 1});
+    origin_.insert(origin_.end(), {org, no_edge, dest, no_edge});
+    is_alive_.push_back(1);
+    return e;
   }
+  is_alive_[e >> 2] = 1;
+  next_[e] = e;
+  next_[e + 1] = e + 3;
+  next_[e + 2] = e + 2;
+  next_[e + 3] = e + 1;
+  origin_[e] = org;
+  origin_[e + 2] = dest;
+  return e;
 }
 
-Point VectorMult(const Point &a, const Point &b) {
-  return {a.y_ * b.z_ - a.z_ * b.y_, a.z_ * b.x_ - a.x_ * b.z_,
-          a.x_ * b.y_ - a.y_ * b.x_, 0};
+void Delaunay::Splice(int32_t a, int32_t b) {
+  int32_t alpha = Rot(next_[a]);
+  int32_t beta = Rot(next_[b]);
+  swap(next_[a], next_[b]);
+  swap(next_[alpha], next_[beta]);
 }
 
-double ScalarMult(const Point &a, const Point &b) {
-  return a.x_ * b.x_ + a.y_ * b.y_ + a.z_ * b.z_;
+int32_t Delaunay::Connect(int32_t a, int32_t b, EdgePool &pool) {
+  int32_t e = MakeEdge(Dest(a), Org(b), pool);
+  Splice(e, Lnext(a));
+  Splice(Sym(e), b);
+  return e;
 }
 
-bool IsTriangleVisible(Point view, Triangle tr) {
-  Point normal = VectorMult(tr.v3_ - tr.v2_, tr.v1_ - tr.v2_);
-  return ScalarMult(normal, view - tr.v1_) > 0 &&
-         ScalarMult(normal, view - tr.v2_) > 0 &&
-         ScalarMult(normal, view - tr.v3_) > 0;
+void Delaunay::DeleteEdge(int32_t e, EdgePool &pool) {
+  Splice(e, Oprev(e));
+  Splice(Sym(e), Oprev(Sym(e)));
+  is_alive_[e >> 2] = 0;
+  pool.free_edges_.push_back(e & ~3);
 }
 
-Triangle MakeNewTriangle(OrientedSegment s, Point p) {
-  if (min(p.index_, min(s.end1_.index_, s.end2_.index_)) == p.index_) {
-    return {p, s.end2_, s.end1_};
+pair<int32_t, int32_t> Delaunay::Triangulate(int32_t begin, int32_t end,
+                                               EdgePool &pool) {
+  if (end - begin == 2) {
+    int32_t a = MakeEdge(begin, begin + 1, pool);
+    return {a, Sym(a)};
   }
-  if (min(p.index_, min(s.end1_.index_, s.end2_.index_)) == s.end1_.index_) {
-    return {s.end1_, p, s.end2_};
+  if (end - begin == 3) {
+    int32_t a = MakeEdge(begin, begin + 1, pool);
+    int32_t b = MakeEdge(begin + 1, begin + 2, pool);
+    Splice(Sym(a), b);
+    if (IsCcw(begin, begin + 1, begin + 2)) {
+      Connect(b, a, pool);
+      return {a, Sym(b)};
+    }
+    if (IsCcw(begin, begin + 2, begin + 1)) {
+      int32_t c = Connect(b, a, pool);
+      return {Sym(c), c};
+    }
+    return {a, Sym(b)};
   }
-  return {s.end2_, s.end1_, p};
+  int32_t middle = begin + (end - begin) / 2;
+  pair<int32_t, int32_t> left = Triangulate(begin, middle, pool);
+  pair<int32_t, int32_t> right = Triangulate(middle, end, pool);
+  return Merge(left, right, pool);
 }
 
-template <>
-class std::hash<Point> {
- public:
-  size_t operator()(const Point &p) const {
-    size_t h1 = hash<double>()(p.x_);
-    size_t h2 = hash<double>()(p.y_);
-    size_t h3 = hash<double>()(p.z_);
-    return h1 * h2 * h3;
+pair<int32_t, int32_t> Delaunay::Merge(pair<int32_t, int32_t> left,
+                                       pair<int32_t, int32_t> right,
+                                       EdgePool &pool) {
+  int32_t ldo = left.first;
+  int32_t ldi = left.second;
+  int32_t rdi = right.first;
+  int32_t rdo = right.second;
+  while (true) {
+    if (IsLeftOf(Org(rdi), ldi)) {
+      ldi = Lnext(ldi);
+    } else if (IsRightOf(Org(ldi), rdi)) {
+      rdi = Rprev(rdi);
+    } else {
+      break;
+    }
   }
-};
-
-template <>
-class std::hash<Triangle> {
- public:
-  size_t operator()(const Triangle &tr) const {
-    size_t h1 = hash<Point>()(tr.v1_);
-    size_t h2 = hash<Point>()(tr.v2_);
-    size_t h3 = hash<Point>()(tr.v3_);
-    return h1 * h2 * h3;
+  int32_t base = Connect(Sym(rdi), ldi, pool);
+  if (Org(ldi) == Org(ldo)) {
+    ldo = Sym(base);
   }
-};
-
-template <typename T>
-struct Triple {
-  T first_;
-  T second_;
-  T third_;
-  Triple(T first, T second, T third)
-      : first_(first), second_(second), third_(third){};
-};
-
-class ConflictGraph {
- private:
-  unordered_map<size_t, Triangle> convex_hill_;
-  vector<Point> ordered_points_;
-  vector<size_t> vision_horizont_;
-  vector<size_t> last_added_faces_ = {0, 1, 2, 3};
-  size_t last_num_face_ = count_faces_of_tetrahedron;
-
-  void ConnectNewTrianglesByEnd2(size_t new_triangle_index,
-                                 Point horizont_point, Point p);
-  void ConnectNewTrianglesByEnd1(size_t new_triangle_index,
-                                 Point horizont_point, Point p);
-  void AddTriangle(Point p, OrientedSegment oriented_s, size_t old_triangle,
-                   size_t neigh_triangle);
-  void AddTwoFaces(Triangle &tr, Triple<size_t> neigh,
-                   Triple<OrientedSegment> seg);
-  size_t FindVisionFace(Point p);
-  void ProcessNeighbour(Point p, size_t current_triangle, queue<size_t> &q,
-                        size_t neighbour_triangle,
-                        OrientedSegment common_segment);
-  void AddPoint(Point p);
+  if (Org(rdi) == Org(rdo)) {
+    rdo = base;
+  }
+  while (true) {
+    int32_t left_candidate = Onext(Sym(base));
+    bool is_left_valid = IsRightOf(Dest(left_candidate), base);
+    if (is_left_valid) {
+      while (IsInCircle(Dest(base), Org(base), Dest(left_candidate),
+                        Dest(Onext(left_candidate)))) {
+        int32_t next = Onext(left_candidate);
+        DeleteEdge(left_candidate, pool);
+        left_candidate = next;
+      }
+    }
+    int32_t right_candidate = Oprev(base);
+    bool is_right_valid = IsRightOf(Dest(right_candidate), base);
+    if (is_right_valid) {
+      while (IsInCircle(Dest(base), Org(base), Dest(right_candidate),
+                        Dest(Oprev(right_candidate)))) {
+        int32_t next = Oprev(right_candidate);
+        DeleteEdge(right_candidate, pool);
+        right_candidate = next;
+      }
+    }
+    if (!is_left_valid && !is_right_valid) {
+      break;
+    }
+    if (!is_left_valid ||
+        (is_right_valid &&
+         IsInCircle(Dest(left_candidate), Org(left_candidate),
+                    Org(right_candidate), Dest(right_candidate)))) {
+      base = Connect(right_candidate, Sym(base), pool);
+    } else {
+      base = Connect(Sym(base), Sym(left_candidate), pool);
+    }
+  }
+  return {ldo, rdo};
+}
 
- public:
-  explicit ConflictGraph(const vector<Point> &ordered_points);
-  vector<Triple<size_t>> OutputHill();
-};
+vector<int32_t> Delaunay::Degrees() const {
+  vector<int32_t> site_degree(SitesCount(), 0);
+  for (size_t quad = 0; quad < is_alive_.size(); ++quad) {
+    if (is_alive_[quad]) {
+      int32_t e = static_cast<int32_t>(quad << 2);
+      ++site_degree[Org(e)];
+      ++site_degree[Dest(e)];
+    }
+  }
+  vector<int32_t> degree(site_of_point_.size(), 0);
+  for (size_t i = 0; i < site_of_point_.size(); ++i) {
+    if (site_of_point_[i] != no_edge) {
+      degree[i] = site_degree[site_of_point_[i]];
+    }
+  }
+  return degree;
+}
 
-ConflictGraph::ConflictGraph(const vector<Point> &ordered_points) {
-  ordered_points_ = ordered_points;
-  vector<Point> sort_by_index = {ordered_points_[0], ordered_points_[1],
-                                 ordered_points_[2], ordered_points_[3]};
-  sort(sort_by_index.begin(), sort_by_index.end());
-  vision_horizont_.resize(ordered_points_.size(), static_cast<size_t>(inf));
-  Point normal = VectorMult(sort_by_index[1] - sort_by_index[0],
-                            sort_by_index[2] - sort_by_index[0]);
-  Triangle first_face;
-  if (ScalarMult(sort_by_index[0] - sort_by_index[3], normal) < 0) {
-    first_face = Triangle(sort_by_index[0], sort_by_index[2], sort_by_index[1]);
-  } else {
-    first_face = Triangle(sort_by_index[0], sort_by_index[1], sort_by_index[2]);
-  }
-  Triangle f1 =
-      MakeNewTriangle({first_face.v1_, first_face.v2_}, sort_by_index[3]);
-  Triangle f2 =
-      MakeNewTriangle({first_face.v2_, first_face.v3_}, sort_by_index[3]);
-  Triangle f3 =
-      MakeNewTriangle({first_face.v3_, first_face.v1_}, sort_by_index[3]);
-  convex_hill_ = {{0, first_face}, {1, f1}, {2, f2}, {3, f3}};
-  AddTwoFaces(convex_hill_[0], {1, 2, 3},
-              {{first_face.v1_, first_face.v2_},
-               {first_face.v2_, first_face.v3_},
-               {first_face.v3_, first_face.v1_}});
-  AddTwoFaces(convex_hill_[1], {0, 3, 2},
-              {{first_face.v2_, first_face.v1_},
-               {first_face.v1_, sort_by_index[3]},
-               {sort_by_index[3], first_face.v2_}});
-  AddTwoFaces(convex_hill_[2], {0, 1, 3},
-              {{first_face.v3_, first_face.v2_},
-               {first_face.v2_, sort_by_index[3]},
-               {sort_by_index[3], first_face.v3_}});
-  AddTwoFaces(convex_hill_[3], {0, 2, 1},
-              {{first_face.v1_, first_face.v3_},
-               {first_face.v3_, sort_by_index[3]},
-               {sort_by_index[3], first_face.v1_}});
-  for (size_t i = last_num_face_; i < ordered_points_.size(); ++i) {
-    AddPoint(ordered_points_[i]);
+vector<char> Delaunay::SiteHullFlags() const {
+  vector<char> is_site_on_hull(SitesCount(), 1);
+  if (hull_edges_.first != no_edge) {
+    is_site_on_hull.assign(SitesCount(), 0);
+    int32_t e = Sym(hull_edges_.first);
+    do {
+      is_site_on_hull[Org(e)] = 1;
+      e = Lnext(e);
+    } while (e != Sym(hull_edges_.first));
   }
+  return is_site_on_hull;
 }
 
-void ConflictGraph::AddTwoFaces(Triangle &tr, Triple<size_t> neigh,
-                                Triple<OrientedSegment> seg) {
-  tr.neighbour1_ = neigh.first_;
-  tr.neighbour2_ = neigh.second_;
-  tr.neighbour3_ = neigh.third_;
-  tr.intersect_neighbour1_ = seg.first_;
-  tr.intersect_neighbour2_ = seg.second_;
-  tr.intersect_neighbour3_ = seg.third_;
+vector<char> Delaunay::HullFlags() const {
+  vector<char> is_site_on_hull = SiteHullFlags();
+  vector<char> is_on_hull(site_of_point_.size(), 1);
+  for (size_t i = 0; i < site_of_point_.size(); ++i) {
+    if (site_of_point_[i] != no_edge) {
+      is_on_hull[i] = is_site_on_hull[site_of_point_[i]];
+    }
+  }
+  return is_on_hull;
 }
 
-void ConflictGraph::ConnectNewTrianglesByEnd1(size_t new_triangle_index,
-                                              Point horizont_point, Point p) {
-  if (vision_horizont_[horizont_point.index_] == static_cast<size_t>(inf)) {
-    vision_horizont_[horizont_point.index_] = new_triangle_index;
-  } else {
-    if (convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour2_ = {horizont_point, p};
-    } else {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour3_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour3_ = {horizont_point, p};
-    }
-
-    if (convex_hill_[new_triangle_index].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[new_triangle_index].neighbour2_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour2_ = {p,
-                                                                horizont_point};
-    } else {
-      convex_hill_[new_triangle_index].neighbour3_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour3_ = {p,
-                                                                horizont_point};
+uint64_t Delaunay::InteriorDegreeSum(size_t threads_count) const {
+  vector<char> is_site_on_hull = SiteHullFlags();
+  vector<uint32_t> weight(SitesCount(), 0);
+  for (int32_t site : site_of_point_) {
+    if (site != no_edge && !is_site_on_hull[site]) {
+      ++weight[site];
     }
-    vision_horizont_[horizont_point.index_] = static_cast<size_t>(inf);
   }
+  threads_count = max(threads_count, size_t(1));
+  size_t quads = is_alive_.size();
+  vector<uint64_t> partial_sums(threads_count, 0);
+  RunParallel(threads_count, threads_count, [&](size_t worker) {
+    uint64_t sum = 0;
+    size_t end = quads * (worker + 1) / threads_count;
+    for (size_t quad = quads * worker / threads_count; quad < end; ++quad) {
+      if (is_alive_[quad]) {
+        int32_t e = static_cast<int32_t>(quad << 2);
+        sum += weight[Org(e)] + weight[Dest(e)];
+      }
+    }
+    partial_sums[worker] = sum;
+  });
+  uint64_t sum = 0;
+  for (uint64_t partial_sum : partial_sums) {
+    sum += partial_sum;
+  }
+  return sum;
 }
 
-void ConflictGraph::ConnectNewTrianglesByEnd2(size_t new_triangle_index,
-                                              Point horizont_point, Point p) {
-  if (vision_horizont_[horizont_point.index_] == static_cast<size_t>(inf)) {
-    vision_horizont_[horizont_point.index_] = new_triangle_index;
-  } else {
-    if (convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour2_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour2_ = {p, horizont_point};
-    } else {
-      convex_hill_[vision_horizont_[horizont_point.index_]].neighbour3_ =
-          new_triangle_index;
-      convex_hill_[vision_horizont_[horizont_point.index_]]
-          .intersect_neighbour3_ = {p, horizont_point};
-    }
-
-    if (convex_hill_[new_triangle_index].neighbour2_ ==
-        static_cast<size_t>(inf)) {
-      convex_hill_[new_triangle_index].neighbour2_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour2_ = {horizont_point,
-                                                                p};
-    } else {
-      convex_hill_[new_triangle_index].neighbour3_ =
-          vision_horizont_[horizont_point.index_];
-      convex_hill_[new_triangle_index].intersect_neighbour3_ = {horizont_point,
-                                                                p};
+void Delaunay::SiteGraph(vector<int32_t> &offsets,
+                         vector<int32_t> &neighbours) const {
+  offsets.assign(SitesCount() + 1, 0);
+  for (size_t quad = 0; quad < is_alive_.size(); ++quad) {
+    if (is_alive_[quad]) {
+      int32_t e = static_cast<int32_t>(quad << 2);
+      ++offsets[Org(e) + 1];
+      ++offsets[Dest(e) + 1];
+    }
+  }
+  for (size_t site = 0; site < SitesCount(); ++site) {
+    offsets[site + 1] += offsets[site];
+  }
+  neighbours.resize(static_cast<size_t>(offsets[SitesCount()]));
+  vector<int32_t> filled(offsets.begin(), offsets.end() - 1);
+  for (size_t quad = 0; quad < is_alive_.size(); ++quad) {
+    if (is_alive_[quad]) {
+      int32_t e = static_cast<int32_t>(quad << 2);
+      neighbours[filled[Org(e)]++] = Dest(e);
+      neighbours[filled[Dest(e)]++] = Org(e);
     }
-    vision_horizont_[horizont_point.index_] = static_cast<size_t>(inf);
   }
 }
 
-void ConflictGraph::AddTriangle(Point p, OrientedSegment oriented_s,
-                                size_t old_triangle, size_t neigh_triangle) {
-  Triangle new_tr = MakeNewTriangle(-oriented_s, p);
-  convex_hill_.emplace(last_num_face_, new_tr);
-  convex_hill_[neigh_triangle].SwapNeighbour(old_triangle, last_num_face_);
-  convex_hill_[last_num_face_].neighbour1_ = neigh_triangle;
-  convex_hill_[last_num_face_].intersect_neighbour1_ = oriented_s;
-  ConnectNewTrianglesByEnd1(last_num_face_, oriented_s.end1_, p);
-  ConnectNewTrianglesByEnd2(last_num_face_, oriented_s.end2_, p);
-  last_added_faces_.push_back(last_num_face_);
-  ++last_num_face_;
+vector<int32_t> Delaunay::LabelTriangles(
+    vector<int32_t> &triangle_edges) const {
+  vector<int32_t> face_of_edge(next_.size() / 2, no_face);
+  for (size_t quad = 0; quad < is_alive_.size(); ++quad) {
+    if (!is_alive_[quad]) {
+      continue;
+    }
+    int32_t edge = static_cast<int32_t>(quad << 2);
+    for (int32_t e : {edge, Sym(edge)}) {
+      int32_t f = Lnext(e);
+      int32_t g = Lnext(f);
+      if (face_of_edge[e >> 1] != no_face || Lnext(g) != e ||
+          !IsCcw(Org(e), Org(f), Org(g))) {
+        continue;
+      }
+      int32_t face = static_cast<int32_t>(triangle_edges.size());
+      face_of_edge[e >> 1] = face;
+      face_of_edge[f >> 1] = face;
+      face_of_edge[g >> 1] = face;
+      triangle_edges.push_back(e);
+    }
+  }
+  return face_of_edge;
 }
 
-size_t ConflictGraph::FindVisionFace(Point p) {
-  for (size_t last_added_face : last_added_faces_) {
-    if (IsTriangleVisible(p, convex_hill_[last_added_face])) {
-      return last_added_face;
+vector<int32_t> Delaunay::MergeCocircular(
+    vector<int32_t> &face_of_edge,
+    const vector<int32_t> &triangle_edges) const {
+  vector<int32_t> parent(triangle_edges.size());
+  for (size_t i = 0; i < parent.size(); ++i) {
+    parent[i] = static_cast<int32_t>(i);
+  }
+  auto find = [&parent](int32_t face) {
+    while (parent[face] != face) {
+      parent[face] = parent[parent[face]];
+      face = parent[face];
+    }
+    return face;
+  };
+  for (size_t quad = 0; quad < is_alive_.size(); ++quad) {
+    int32_t e = static_cast<int32_t>(quad << 2);
+    if (!is_alive_[quad] || face_of_edge[e >> 1] == no_face ||
+        face_of_edge[Sym(e) >> 1] == no_face) {
+      continue;
+    }
+    int32_t a = Org(e);
+    int32_t b = Dest(e);
+    int32_t c = Dest(Lnext(e));
+    int32_t d = Dest(Lnext(Sym(e)));
+    if (InCircle(xs_[a], ys_[a], xs_[b], ys_[b], xs_[c], ys_[c], xs_[d],
+                 ys_[d]) == 0) {
+      parent[find(face_of_edge[e >> 1])] = find(face_of_edge[Sym(e) >> 1]);
+    }
+  }
+  vector<int32_t> vertex_of_face(triangle_edges.size(), no_face);
+  vector<int32_t> vertex_edges;
+  for (size_t face = 0; face < triangle_edges.size(); ++face) {
+    int32_t root = find(static_cast<int32_t>(face));
+    if (vertex_of_face[root] == no_face) {
+      vertex_of_face[root] = static_cast<int32_t>(vertex_edges.size());
+      vertex_edges.push_back(triangle_edges[root]);
     }
   }
-  return static_cast<size_t>(inf);
+  for (int32_t &face : face_of_edge) {
+    if (face != no_face) {
+      face = vertex_of_face[find(face)];
+    }
+  }
+  return vertex_edges;
 }
 
-void ConflictGraph::ProcessNeighbour(Point p, size_t current_triangle,
-                                     queue<size_t> &q,
-                                     size_t neighbour_triangle,
-                                     OrientedSegment common_segment) {
-  if (convex_hill_.find(neighbour_triangle) == convex_hill_.end()) {
-    return;
+vector<int32_t> Delaunay::SiteCell(int32_t e,
+                                   const vector<int32_t> &face_of_edge,
+                                   bool &is_bounded) const {
+  int32_t start = e;
+  is_bounded = true;
+  do {
+    if (face_of_edge[Oprev(e) >> 1] == no_face) {
+      start = e;
+      is_bounded = false;
+      break;
+    }
+    e = Onext(e);
+  } while (e != start);
+  vector<int32_t> cell;
+  e = start;
+  do {
+    int32_t vertex = face_of_edge[e >> 1];
+    if (vertex == no_face) {
+      break;
+    }
+    if (cell.empty() || cell.back() != vertex) {
+      cell.push_back(vertex);
+    }
+    e = Onext(e);
+  } while (e != start);
+  if (is_bounded && cell.size() > 1 && cell.front() == cell.back()) {
+    cell.pop_back();
   }
+  return cell;
+}
 
-  if (!IsTriangleVisible(p, convex_hill_[neighbour_triangle])) {
-    AddTriangle(p, common_segment, current_triangle, neighbour_triangle);
-  } else {
-    q.push(neighbour_triangle);
+VoronoiDiagram Delaunay::Voronoi() const {
+  VoronoiDiagram diagram;
+  vector<int32_t> triangle_edges;
+  vector<int32_t> face_of_edge = LabelTriangles(triangle_edges);
+  vector<int32_t> vertex_edges = MergeCocircular(face_of_edge, triangle_edges);
+  for (int32_t e : vertex_edges) {
+    int32_t a = Org(e);
+    int32_t b = Dest(e);
+    int32_t c = Dest(Lnext(e));
+    double bx = xs_[b] - xs_[a];
+    double by = ys_[b] - ys_[a];
+    double cx = xs_[c] - xs_[a];
+    double cy = ys_[c] - ys_[a];
+    double b_lift = bx * bx + by * by;
+    double c_lift = cx * cx + cy * cy;
+    double denominator = 2 * (bx * cy - by * cx);
+    diagram.vertex_xs_.push_back(xs_[a] +
+                                 (cy * b_lift - by * c_lift) / denominator);
+    diagram.vertex_ys_.push_back(ys_[a] +
+                                 (bx * c_lift - cx * b_lift) / denominator);
+  }
+  vector<int32_t> edge_of_site(SitesCount(), no_edge);
+  for (size_t quad = 0; quad < is_alive_.size(); ++quad) {
+    if (is_alive_[quad]) {
+      int32_t e = static_cast<int32_t>(quad << 2);
+      edge_of_site[Org(e)] = e;
+      edge_of_site[Dest(e)] = Sym(e);
+    }
+  }
+  vector<int32_t> site_offsets(SitesCount() + 1, 0);
+  vector<int32_t> site_vertices;
+  vector<char> is_site_bounded(SitesCount(), 0);
+  vector<double> site_areas(SitesCount(), unbounded_area);
+  for (size_t site = 0; site < SitesCount(); ++site) {
+    if (edge_of_site[site] != no_edge) {
+      bool is_bounded;
+      vector<int32_t> cell =
+          SiteCell(edge_of_site[site], face_of_edge, is_bounded);
+      if (is_bounded) {
+        double area = 0;
+        for (size_t i = 0; i < cell.size(); ++i) {
+          int32_t u = cell[i];
+          int32_t v = cell[(i + 1) % cell.size()];
+          area += diagram.vertex_xs_[u] * diagram.vertex_ys_[v] -
+                  diagram.vertex_xs_[v] * diagram.vertex_ys_[u];
+        }
+        is_site_bounded[site] = 1;
+        site_areas[site] = area / 2;
+      }
+      site_vertices.insert(site_vertices.end(), cell.begin(), cell.end());
+    }
+    site_offsets[site + 1] = static_cast<int32_t>(site_vertices.size());
   }
+  diagram.cell_offsets_.push_back(0);
+  for (int32_t site : site_of_point_) {
+    if (site != no_edge) {
+      diagram.cell_vertices_.insert(
+          diagram.cell_vertices_.end(),
+          site_vertices.begin() + site_offsets[site],
+          site_vertices.begin() + site_offsets[site + 1]);
+      diagram.is_bounded_.push_back(is_site_bounded[site]);
+      diagram.areas_.push_back(site_areas[site]);
+    } else {
+      diagram.is_bounded_.push_back(0);
+      diagram.areas_.push_back(unbounded_area);
+    }
+    diagram.cell_offsets_.push_back(
+        static_cast<int32_t>(diagram.cell_vertices_.size()));
+  }
+  return diagram;
+}
+
+uint32_t SpreadBits(uint32_t value) {
+  value = (value | (value << 8)) & 0x00ff00ff;
+  value = (value | (value << 4)) & 0x0f0f0f0f;
+  value = (value | (value << 2)) & 0x33333333;
+  value = (value | (value << 1)) & 0x55555555;
+  return value;
 }
 
-void ConflictGraph::AddPoint(Point p) {
-  size_t vision_face = FindVisionFace(p);
-  if (vision_face == static_cast<size_t>(inf)) {
+class CellLocator {
+ private:
+  vector<double> xs_;
+  vector<double> ys_;
+  vector<int32_t> offsets_;
+  vector<int32_t> neighbours_;
+  vector<size_t> point_of_site_;
+  vector<int32_t> seeds_;
+  double min_x_ = 0;
+  double min_y_ = 0;
+  double cell_width_ = 1;
+  double cell_height_ = 1;
+  size_t grid_size_ = 1;
+
+  double Distance(int32_t site, double x, double y) const {
+    double dx = xs_[site] - x;
+    double dy = ys_[site] - y;
+    return dx * dx + dy * dy;
+  }
+  size_t GridCoordinate(double value, double origin, double step) const;
+  size_t GridCell(double x, double y) const;
+  int32_t Walk(int32_t site, double x, double y) const;
+  uint32_t MortonCode(double x, double y) const;
+
+ public:
+  explicit CellLocator(const Delaunay &triangulation);
+  size_t Locate(double x, double y) const;
+  vector<size_t> LocateBatch(const vector<pair<double, double>> &queries) const;
+};
+
+CellLocator::CellLocator(const Delaunay &triangulation) {
+  size_t sites = triangulation.SitesCount();
+  if (sites == 0) {
     return;
   }
-  last_added_faces_.clear();
-  queue<size_t> q;
-  q.push(vision_face);
-  while (!q.empty()) {
-    size_t current_triangle = q.front();
-    q.pop();
-    if (convex_hill_.find(current_triangle) == convex_hill_.end()) {
-      continue;
+  xs_.resize(sites);
+  ys_.resize(sites);
+  for (size_t site = 0; site < sites; ++site) {
+    xs_[site] = triangulation.SiteX(static_cast<int32_t>(site));
+    ys_[site] = triangulation.SiteY(static_cast<int32_t>(site));
+  }
+  triangulation.SiteGraph(offsets_, neighbours_);
+  point_of_site_.assign(sites, no_point);
+  const vector<int32_t> &site_of_point = triangulation.SitesOfPoints();
+  for (size_t point = 0; point < site_of_point.size(); ++point) {
+    int32_t site = site_of_point[point];
+    if (site != no_edge && point_of_site_[site] == no_point) {
+      point_of_site_[site] = point;
+    }
+  }
+  min_x_ = *std::min_element(xs_.begin(), xs_.end());
+  min_y_ = *std::min_element(ys_.begin(), ys_.end());
+  double width = *std::max_element(xs_.begin(), xs_.end()) - min_x_;
+  double height = *std::max_element(ys_.begin(), ys_.end()) - min_y_;
+  double grid_size =
+      std::floor(std::sqrt(static_cast<double>(sites / sites_per_seed)));
+  grid_size_ = max(size_t(1), static_cast<size_t>(grid_size));
+  grid_size = static_cast<double>(grid_size_);
+  cell_width_ = width > 0 ? width / grid_size : 1;
+  cell_height_ = height > 0 ? height / grid_size : 1;
+  seeds_.resize(grid_size_ * grid_size_);
+  int32_t site = 0;
+  for (size_t row = 0; row < grid_size_; ++row) {
+    for (size_t i = 0; i < grid_size_; ++i) {
+      size_t column = row % 2 == 0 ? i : grid_size_ - 1 - i;
+      double x = min_x_ + (static_cast<double>(column) + 0.5) * cell_width_;
+      double y = min_y_ + (static_cast<double>(row) + 0.5) * cell_height_;
+      site = Walk(site, x, y);
+      seeds_[row * grid_size_ + column] = site;
     }
-    ProcessNeighbour(p, current_triangle, q,
-                     convex_hill_[current_triangle].neighbour1_,
-                     convex_hill_[current_triangle].intersect_neighbour1_);
-    ProcessNeighbour(p, current_triangle, q,
-                     convex_hill_[current_triangle].neighbour2_,
-                     convex_hill_[current_triangle].intersect_neighbour2_);
-    ProcessNeighbour(p, current_triangle, q,
-                     convex_hill_[current_triangle].neighbour3_,
-                     convex_hill_[current_triangle].intersect_neighbour3_);
-    convex_hill_.erase(current_triangle);
   }
 }
 
-vector<Triple<size_t>> ConflictGraph::OutputHill() {
-  vector<Triple<size_t>> result;
-  for (auto i = convex_hill_.begin(); i != convex_hill_.end(); ++i) {
-    result.emplace_back(i->second.v1_.index_, i->second.v2_.index_,
-                        i->second.v3_.index_);
+size_t CellLocator::GridCoordinate(double value, double origin,
+                                   double step) const {
+  double coordinate = (value - origin) / step;
+  if (!(coordinate > 0)) {
+    return 0;
   }
-  return result;
+  return min(static_cast<size_t>(coordinate), grid_size_ - 1);
+}
+
+size_t CellLocator::GridCell(double x, double y) const {
+  return GridCoordinate(y, min_y_, cell_height_) * grid_size_ +
+         GridCoordinate(x, min_x_, cell_width_);
 }
 
-bool Compare(Point p1, Point p2) {
-  return p1.x_ < p2.x_ || (fabs(p1.x_ - p2.x_) < eps && p1.y_ < p2.y_) ||
-         (fabs(p1.x_ - p2.x_) < eps && fabs(p1.y_ - p2.y_) < eps &&
-          p1.z_ < p2.z_);
+int32_t CellLocator::Walk(int32_t site, double x, double y) const {
+  double distance = Distance(site, x, y);
+  while (true) {
+    int32_t closer = site;
+    for (int32_t k = offsets_[site]; k < offsets_[site + 1]; ++k) {
+      double candidate = Distance(neighbours_[k], x, y);
+      if (candidate < distance) {
+        distance = candidate;
+        closer = neighbours_[k];
+      }
+    }
+    if (closer == site) {
+      return site;
+    }
+    site = closer;
+  }
 }
 
-bool CompareByAngle(Point p1, Point p2) {
-  return p1.y_ / p1.x_ < p2.y_ / p2.x_;
+uint32_t CellLocator::MortonCode(double x, double y) const {
+  double grid_size = static_cast<double>(grid_size_);
+  double scale = morton_scale / grid_size;
+  auto quantize = [scale](double value) {
+    double scaled = value * scale;
+    if (!(scaled > 0)) {
+      return uint32_t(0);
+    }
+    return static_cast<uint32_t>(min(scaled, morton_scale));
+  };
+  return SpreadBits(quantize((x - min_x_) / cell_width_)) |
+         (SpreadBits(quantize((y - min_y_) / cell_height_)) << 1);
 }
 
-void SortByAngle(vector<Point> &points) {
-  Point first = points[0];
-  for (size_t i = 1; i < points.size(); ++i) {
-    points[i] = points[i] - first;
-  }
-  sort(points.begin() + 1, points.end(), CompareByAngle);
-  for (size_t i = 1; i < points.size(); ++i) {
-    points[i] = points[i] + first;
+size_t CellLocator::Locate(double x, double y) const {
+  if (xs_.empty()) {
+    return no_point;
   }
+  return point_of_site_[Walk(seeds_[GridCell(x, y)], x, y)];
 }
 
-double VectorMult2(Point p1, Point p2) { return p1.x_ * p2.y_ - p1.y_ * p2.x_; }
-
-vector<size_t> PlainConvexHull(vector<Point> &points) {
-  stack<Point> hull;
-  points.push_back(points[0]);
-  hull.push(points[0]);
-  hull.push(points[1]);
-  Point last_point1 = points[0];
-  Point last_point2 = points[1];
-  for (size_t i = 2; i < points.size(); ++i) {
-    while (VectorMult2(points[i] - last_point2, last_point1 - last_point2) <
-           0.0) {
-      last_point2 = last_point1;
-      hull.pop();
-      hull.pop();
-      last_point1 = hull.top();
-      hull.push(last_point2);
-    }
-    hull.push(points[i]);
-    last_point1 = last_point2;
-    last_point2 = points[i];
-  }
-  vector<size_t> res;
-  while (hull.size() != 1) {
-    res.push_back(hull.top().index_);
-    hull.pop();
-  }
-  points.pop_back();
-  return res;
+vector<size_t> CellLocator::LocateBatch(
+    const vector<pair<double, double>> &queries) const {
+  vector<size_t> result(queries.size(), no_point);
+  if (xs_.empty()) {
+    return result;
+  }
+  vector<pair<uint32_t, size_t>> order(queries.size());
+  for (size_t i = 0; i < queries.size(); ++i) {
+    order[i] = {MortonCode(queries[i].first, queries[i].second), i};
+  }
+  sort(order.begin(), order.end());
+  int32_t site = seeds_[0];
+  for (const pair<uint32_t, size_t> &query : order) {
+    double x = queries[query.second].first;
+    double y = queries[query.second].second;
+    int32_t seed = seeds_[GridCell(x, y)];
+    if (Distance(seed, x, y) < Distance(site, x, y)) {
+      site = seed;
+    }
+    site = Walk(site, x, y);
+    result[query.second] = point_of_site_[site];
+  }
+  return result;
 }
 
-double CountAvgVoronoy(const vector<Point> &points) {
-  if (points.size() < count_faces_of_tetrahedron) {
+double CountAvgVoronoy(const vector<Point> &points, size_t threads_count) {
+  if (points.size() < min_points_for_cells) {
     return 0.0;
   }
-  auto points_by_angle = points;
-  SortByAngle(points_by_angle);
-  ConflictGraph dim3_hull(points);
-  vector<int> polygon_deg(points.size(), 0);
-  vector<Triple<size_t>> faces = dim3_hull.OutputHill();
-  for (size_t i = 0; i < faces.size(); ++i) {
-    ++polygon_deg[faces[i].first_];
-    ++polygon_deg[faces[i].second_];
-    ++polygon_deg[faces[i].third_];
-  }
-  vector<size_t> non_polygon_points = PlainConvexHull(points_by_angle);
-  if (non_polygon_points.size() == points.size()) {
+  Delaunay triangulation(points, threads_count);
+  vector<char> is_on_hull = triangulation.HullFlags();
+  size_t count_polygons = 0;
+  for (char is_hull_point : is_on_hull) {
+    count_polygons += is_hull_point ? 0 : 1;
+  }
+  if (count_polygons == 0) {
     return 0.0;
   }
-  vector<bool> is_polygon(points.size(), true);
-  for (size_t i = 0; i < non_polygon_points.size(); ++i) {
-    is_polygon[non_polygon_points[i]] = false;
+  return static_cast<double>(triangulation.InteriorDegreeSum(threads_count)) /
+         static_cast<double>(count_polygons);
+}
+
+vector<Point> ReadPoints(FILE *file) {
+  string input;
+  char chunk[read_chunk_size];
+  size_t read;
+  while ((read = fread(chunk, 1, read_chunk_size, file)) > 0) {
+    input.append(chunk, read);
   }
-  int count_segments = 0;
-  for (size_t i = 0; i < points.size(); ++i) {
-    if (is_polygon[i]) {
-      count_segments += polygon_deg[i];
+  vector<Point> points;
+  const char *position = input.c_str();
+  while (true) {
+    char *end;
+    double x = strtod(position, &end);
+    if (end == position) {
+      break;
     }
+    position = end;
+    double y = strtod(position, &end);
+    if (end == position) {
+      break;
+    }
+    position = end;
+    points.emplace_back(x, y, points.size());
   }
-  return static_cast<double>(count_segments) /
-         static_cast<double>(points.size() - non_polygon_points.size());
+  return points;
 }
 
 int main() {
-  vector<Point> points;
-  double x;
-  double y;
-  int i = 0;
-  while (cin >> x) {
-    cin >> y;
-    points.emplace_back(x, y, x * x + y * y, i);
-    ++i;
-  }
-  sort(points.begin(), points.end(), Compare);
+  vector<Point> points = ReadPoints(stdin);
+  size_t threads_count = std::thread::hardware_concurrency();
   std::cout.precision(precision);
-  cout << CountAvgVoronoy(points) << endl;
+  cout << CountAvgVoronoy(points, threads_count) << endl;
   return 0;
 }
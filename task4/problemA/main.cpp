@@ -1,5 +1,9 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 using std::cin;
@@ -10,6 +14,18 @@ using std::min;
 using std::string;
 using std::vector;
 
+// A number transformed once modulo each NTT prime at a power of two length,
+// for cyclic convolutions of that length with many other numbers.
+struct NttFactor {
+  size_t size_ = 0;
+  vector<uint32_t> transform1_;
+  vector<uint32_t> transform2_;
+  vector<uint32_t> transform3_;
+
+  NttFactor() = default;
+  NttFactor(const uint32_t *a, size_t a_size, size_t n);
+};
+
 class BigInteger {
  public:
   BigInteger();
@@ -48,27 +64,131 @@ class BigInteger {
   friend BigInteger operator+(BigInteger a, const BigInteger &b);
   friend BigInteger operator-(BigInteger a, const BigInteger &c);
 
+  friend std::pair<BigInteger, BigInteger> divmod(const BigInteger &a,
+                                                  const BigInteger &b);
+
  private:
   bool is_nonnegative;
-  std::vector<int> num;
+  std::vector<uint32_t> num;
 
-  BigInteger(bool sign, vector<int> a)
+  BigInteger(bool sign, vector<uint32_t> a)
       : is_nonnegative(sign), num(std::move(a)){};
   static void dif(BigInteger &a, const BigInteger &b);
   static void sum(BigInteger &a, const BigInteger &b);
   static BigInteger mult(const BigInteger &a, const BigInteger &b);
-  static void div(BigInteger &a, const BigInteger &b);
-  static BigInteger linear_mult(const BigInteger &a, int m);
-  BigInteger abs(BigInteger b) {
+  static BigInteger div(BigInteger &a, const BigInteger &b);
+  static BigInteger knuth_div(BigInteger &a, const BigInteger &b);
+  static BigInteger div_2n_1n(BigInteger &a, const BigInteger &b, size_t n);
+  static BigInteger div_3n_2n(BigInteger &a, const BigInteger &b,
+                              size_t half);
+  static BigInteger limbs(const BigInteger &a, size_t begin, size_t end);
+  static void shift_limbs(BigInteger &a, size_t count);
+  static void shift_left(BigInteger &a, size_t bits);
+  static void shift_right(BigInteger &a, size_t bits);
+  static BigInteger fold(const BigInteger &a, size_t size);
+  static BigInteger mult_wrapped(const BigInteger &a, const BigInteger &b,
+                                 size_t size);
+  static BigInteger mult_transformed(const BigInteger &a, const NttFactor &b);
+  static BigInteger wrapped_difference(const BigInteger &a,
+                                       const BigInteger &b, size_t size);
+  static BigInteger reciprocal(const BigInteger &d);
+  struct BarrettDivisor;
+  static BigInteger barrett_div(BigInteger &a, const BarrettDivisor &d);
+  static const BigInteger &decimal_power(size_t level);
+  static const BarrettDivisor &decimal_divisor(size_t level);
+  static size_t decimal_level(const BigInteger &a);
+  static void write_decimal(const BigInteger &a, size_t level, char *out);
+  static BigInteger parse_decimal(const char *digits, size_t size);
+  static BigInteger abs(BigInteger b) {
     b.is_nonnegative = true;
     return b;
   }
-  static void pow_10(BigInteger &a, int pow);
   void DeleteZeros();
   bool CompareIfSignsAreTheSame(BigInteger const &n, BigInteger const &m) const;
   friend void PushStrToNum(const string &s, BigInteger &n, int start_ind);
+  friend bool CheckWrappedSquare(size_t limbs, size_t size);
+};
+
+// A divisor d of n limbs prepared for Barrett division: its reciprocal
+// floor(B^(2n) / d) and, when long, the transforms of both that the two
+// products of every division by it share.
+struct BigInteger::BarrettDivisor {
+  BigInteger divisor_;
+  BigInteger reciprocal_;
+  size_t wrapped_size_;
+  bool transformed_;
+  NttFactor reciprocal_transform_;
+  NttFactor divisor_transform_;
+
+  explicit BarrettDivisor(const BigInteger &divisor);
 };
 
+const uint32_t decimal_base = 1000000000;
+const size_t decimal_base_digits = 9;
+const size_t karatsuba_threshold = 32;
+const size_t burnikel_ziegler_threshold = 64;
+const size_t radix_conversion_threshold = 64;
+const size_t newton_threshold = 64;
+const size_t ntt_threshold = 1024;
+const size_t max_ntt_size = size_t(1) << 23;
+const size_t max_ntt_factor = size_t(1) << 22;
+const size_t ntt_block_size = size_t(1) << 13;
+const uint32_t ntt_modulus1 = 998244353;
+const uint32_t ntt_modulus2 = 167772161;
+const uint32_t ntt_modulus3 = 469762049;
+const uint32_t ntt_generator = 3;
+
+uint32_t AddSpan(uint32_t *a, size_t a_size, const uint32_t *b,
+                 size_t b_size) {
+  uint64_t transfer = 0;
+  for (size_t i = 0; i < b_size; ++i) {
+    transfer += static_cast<uint64_t>(a[i]) + b[i];
+    a[i] = static_cast<uint32_t>(transfer);
+    transfer >>= 32;
+  }
+  for (size_t i = b_size; i < a_size && transfer != 0; ++i) {
+    transfer += a[i];
+    a[i] = static_cast<uint32_t>(transfer);
+    transfer >>= 32;
+  }
+  return static_cast<uint32_t>(transfer);
+}
+
+uint32_t SubtractSpan(uint32_t *a, size_t a_size, const uint32_t *b,
+                      size_t b_size) {
+  uint32_t borrow = 0;
+  for (size_t i = 0; i < b_size; ++i) {
+    uint64_t subtrahend = static_cast<uint64_t>(b[i]) + borrow;
+    borrow = a[i] < subtrahend ? 1 : 0;
+    a[i] = static_cast<uint32_t>(a[i] - subtrahend);
+  }
+  for (size_t i = b_size; i < a_size && borrow != 0; ++i) {
+    borrow = a[i] == 0 ? 1 : 0;
+    --a[i];
+  }
+  return borrow;
+}
+
+uint32_t MultiplyAddSpan(uint32_t *a, size_t size, uint32_t m, uint32_t add) {
+  uint64_t transfer = add;
+  for (size_t i = 0; i < size; ++i) {
+    transfer += static_cast<uint64_t>(a[i]) * m;
+    a[i] = static_cast<uint32_t>(transfer);
+    transfer >>= 32;
+  }
+  return static_cast<uint32_t>(transfer);
+}
+
+uint32_t DivideSpan(uint32_t *a, size_t size, uint32_t d) {
+  uint64_t remainder = 0;
+  for (size_t i = size; i > 0; --i) {
+    uint64_t current = remainder << 32 | a[i - 1];
+    a[i - 1] = static_cast<uint32_t>(current / d);
+    remainder = current % d;
+  }
+  return static_cast<uint32_t>(remainder);
+}
+
 BigInteger::operator bool() { return *this != 0; }
 
 void BigInteger::DeleteZeros() {
@@ -83,15 +203,13 @@ void BigInteger::DeleteZeros() {
 BigInteger::BigInteger() { is_nonnegative = true; }
 
 BigInteger::BigInteger(int a) {
+  is_nonnegative = a >= 0;
+  uint32_t magnitude = static_cast<uint32_t>(a);
   if (a < 0) {
-    is_nonnegative = false;
-    a *= -1;
-  } else {
-    is_nonnegative = true;
+    magnitude = 0 - magnitude;
   }
-  while (a > 0) {
-    num.push_back(a % 10);
-    a /= 10;
+  if (magnitude != 0) {
+    num.push_back(magnitude);
   }
 }
 
@@ -133,73 +251,30 @@ bool BigInteger::operator>=(BigInteger const &b) const { return !(*this < b); }
 bool BigInteger::operator!=(BigInteger const &b) const { return !(*this == b); }
 
 BigInteger BigInteger::operator-() const {
-  return {!this->is_nonnegative, this->num};
+  BigInteger res(!this->is_nonnegative, this->num);
+  res.DeleteZeros();
+  return res;
 }
 
 void BigInteger::sum(BigInteger &a, const BigInteger &b) {
-  size_t least = min(a.num.size(), b.num.size());
-  size_t largest = max(a.num.size(), b.num.size());
-  int transfer = 0;
-  for (size_t i = 0; i < least; ++i) {
-    int cur_sum = a.num[i] + b.num[i] + transfer;
-    a.num[i] = cur_sum % 10;
-    transfer = cur_sum / 10;
-  }
-
-  if (a.num.size() == largest) {
-    for (size_t i = least; i < largest; ++i) {
-      int cur_sum = a.num[i] + transfer;
-      a.num[i] = cur_sum % 10;
-      transfer = cur_sum / 10;
-    }
-  } else {
-    for (size_t i = least; i < largest; ++i) {
-      a.num.push_back((b.num[i] + transfer) % 10);
-      transfer = (b.num[i] + transfer) / 10;
-    }
+  if (a.num.size() < b.num.size()) {
+    a.num.resize(b.num.size());
   }
-
+  uint32_t transfer =
+      AddSpan(a.num.data(), a.num.size(), b.num.data(), b.num.size());
   if (transfer != 0) {
     a.num.push_back(transfer);
   }
 }
 
-void PlusDigit(int &cur_dif, int &transfer) {
-  if (cur_dif < 0) {
-    cur_dif += 10;
-    transfer = 1;
-  } else {
-    transfer = 0;
-  }
-}
-
 void BigInteger::dif(BigInteger &a, const BigInteger &b) {
-  if ((a >= b && a.is_nonnegative) || (a <= b && !a.is_nonnegative)) {
-    int transfer = 0;
-    int cur_dif = 0;
-    for (size_t i = 0; i < b.num.size(); ++i) {
-      cur_dif = a.num[i] - transfer - b.num[i];
-      a.num[i] = cur_dif;
-    }
-    for (size_t i = b.num.size(); i < a.num.size(); ++i) {
-      cur_dif = a.num[i] - transfer;
-      PlusDigit(cur_dif, transfer);
-      a.num[i] = cur_dif;
-    }
+  if (!a.CompareIfSignsAreTheSame(b, a)) {
+    SubtractSpan(a.num.data(), a.num.size(), b.num.data(), b.num.size());
   } else {
     a.is_nonnegative = !a.is_nonnegative;
-    int transfer = 0;
-    int cur_dif = 0;
-    for (size_t i = 0; i < a.num.size(); ++i) {
-      cur_dif = b.num[i] - transfer - a.num[i];
-      PlusDigit(cur_dif, transfer);
-      a.num[i] = cur_dif;
-    }
-    for (size_t i = a.num.size(); i < b.num.size(); ++i) {
-      cur_dif = b.num[i] - transfer;
-      PlusDigit(cur_dif, transfer);
-      a.num.push_back(cur_dif);
-    }
+    vector<uint32_t> res = b.num;
+    SubtractSpan(res.data(), res.size(), a.num.data(), a.num.size());
+    a.num.swap(res);
   }
   a.DeleteZeros();
 }
@@ -234,29 +309,142 @@ BigInteger operator-(BigInteger a, const BigInteger &b) {
   return a;
 }
 
+// 10^(9 * 2^level), squared from the previous level on first use.
+const BigInteger &BigInteger::decimal_power(size_t level) {
+  static vector<BigInteger> powers(1, BigInteger(decimal_base));
+  while (powers.size() <= level) {
+    powers.push_back(powers.back() * powers.back());
+  }
+  return powers[level];
+}
+
+// decimal_power(level) prepared for Barrett division on first use.
+const BigInteger::BarrettDivisor &BigInteger::decimal_divisor(size_t level) {
+  static vector<BarrettDivisor> divisors;
+  while (divisors.size() <= level) {
+    divisors.emplace_back(decimal_power(divisors.size()));
+  }
+  return divisors[level];
+}
+
+// The smallest level with |a| < decimal_power(level), so that a has at most
+// 9 * 2^level digits. The next power has 2s - 1 or 2s limbs for s limbs of
+// the current one, so it is only squared when the sizes cannot decide.
+size_t BigInteger::decimal_level(const BigInteger &a) {
+  size_t level = 0;
+  while (true) {
+    const BigInteger &power = decimal_power(level);
+    if (a.num.size() < power.num.size() ||
+        (a.num.size() == power.num.size() && abs(a) < power)) {
+      return level;
+    }
+    if (a.num.size() + 2 <= 2 * power.num.size()) {
+      return level + 1;
+    }
+    ++level;
+  }
+}
+
+// Writes exactly 9 * 2^level digits of a >= 0 to out, zero padded, splitting
+// it by the cached powers of ten down to small numbers.
+void BigInteger::write_decimal(const BigInteger &a, size_t level, char *out) {
+  size_t width = decimal_base_digits << level;
+  if (level == 0 || a.num.size() <= radix_conversion_threshold) {
+    vector<uint32_t> magnitude = a.num;
+    char *end = out + width;
+    while (magnitude.size() > 0) {
+      uint32_t chunk =
+          DivideSpan(magnitude.data(), magnitude.size(), decimal_base);
+      for (size_t i = 0; i < decimal_base_digits; ++i) {
+        *--end = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+      }
+      while (magnitude.size() > 0 && magnitude.back() == 0) {
+        magnitude.pop_back();
+      }
+    }
+    std::fill(out, end, '0');
+    return;
+  }
+  BigInteger low = a;
+  BigInteger high = barrett_div(low, decimal_divisor(level - 1));
+  write_decimal(high, level - 1, out);
+  write_decimal(low, level - 1, out + width / 2);
+}
+
+BigInteger BigInteger::parse_decimal(const char *digits, size_t size) {
+  BigInteger res;
+  if (size > radix_conversion_threshold * decimal_base_digits) {
+    size_t level = 0;
+    while ((decimal_base_digits << (level + 1)) < size) {
+      ++level;
+    }
+    size_t low = decimal_base_digits << level;
+    res = parse_decimal(digits, size - low);
+    res *= decimal_power(level);
+    res += parse_decimal(digits + size - low, low);
+    return res;
+  }
+  size_t head = size % decimal_base_digits;
+  size_t i = 0;
+  while (i < size) {
+    size_t end = i + (i == 0 && head != 0 ? head : decimal_base_digits);
+    uint32_t chunk = 0;
+    uint32_t scale = 1;
+    for (; i < end; ++i) {
+      chunk = chunk * 10 + static_cast<uint32_t>(digits[i] - '0');
+      scale *= 10;
+    }
+    uint32_t transfer =
+        MultiplyAddSpan(res.num.data(), res.num.size(), scale, chunk);
+    if (transfer != 0) {
+      res.num.push_back(transfer);
+    }
+  }
+  res.DeleteZeros();
+  return res;
+}
+
 const string BigInteger::toString() const {
   if (this->num.size() == 0) {
     return "0";
   }
-  string s;
-  if (!this->is_nonnegative) {
-    s += "-";
-  }
-  for (size_t i = this->num.size(); i > 0; --i) {
-    s += static_cast<char>('0' + this->num[i - 1]);
+  size_t level = decimal_level(*this);
+  string s((decimal_base_digits << level) + 1, '-');
+  write_decimal(abs(*this), level, &s[1]);
+  size_t first = s.find_first_not_of('0', 1);
+  if (this->is_nonnegative) {
+    s.erase(0, first);
+  } else {
+    s.erase(1, first - 1);
   }
   return s;
 }
 
 std::ostream &operator<<(std::ostream &out, const BigInteger &n) {
-  out << n.toString();
+  if (n.num.size() == 0) {
+    return out << '0';
+  }
+  size_t level = BigInteger::decimal_level(n);
+  vector<char> buffer(decimal_base_digits << level);
+  BigInteger::write_decimal(BigInteger::abs(n), level, buffer.data());
+  size_t first = 0;
+  while (buffer[first] == '0') {
+    ++first;
+  }
+  if (!n.is_nonnegative) {
+    out << '-';
+  }
+  out.write(buffer.data() + first,
+            static_cast<std::streamsize>(buffer.size() - first));
   return out;
 }
 
 void PushStrToNum(const string &s, BigInteger &n, int start_ind) {
-  for (size_t i = s.size() - 1 - start_ind; i > 0; --i) {
-    n.num.push_back(s[i] - '0');
-  }
+  size_t start = static_cast<size_t>(start_ind);
+  bool sign = n.is_nonnegative;
+  n = BigInteger::parse_decimal(s.data() + start, s.size() - start);
+  n.is_nonnegative = sign;
 }
 
 std::istream &operator>>(std::istream &in, BigInteger &n) {
@@ -268,10 +456,10 @@ std::istream &operator>>(std::istream &in, BigInteger &n) {
   } else {
     if (input[0] == '-') {
       n.is_nonnegative = false;
-      PushStrToNum(input, n, 0);
+      PushStrToNum(input, n, 1);
     } else {
       n.is_nonnegative = true;
-      PushStrToNum(input, n, 1);
+      PushStrToNum(input, n, 0);
     }
   }
   n.DeleteZeros();
@@ -300,61 +488,662 @@ BigInteger BigInteger::operator--(int) {
   return copy;
 }
 
-void BigInteger::div(BigInteger &a, const BigInteger &b) {
-  BigInteger curr_num;
-  for (size_t i = a.num.size(); i > 0; --i) {
-    curr_num *= 10;
-    curr_num += a.num[i - 1];
-    int digit = 1;
-    while (curr_num >= b * digit) {
-      ++digit;
+int CountLeadingZeros(uint32_t limb) {
+  int count = 0;
+  for (uint32_t bit = uint32_t(1) << 31; bit != 0 && (limb & bit) == 0;
+       bit >>= 1) {
+    ++count;
+  }
+  return count;
+}
+
+// a shifted left by shift < 32 bits, in size limbs.
+vector<uint32_t> ShiftedLimbs(const vector<uint32_t> &a, int shift,
+                              size_t size) {
+  vector<uint32_t> res(size);
+  for (size_t i = 0; i < a.size() && i < size; ++i) {
+    res[i] |= a[i] << shift;
+    if (shift != 0 && i + 1 < size) {
+      res[i + 1] = a[i] >> (32 - shift);
+    }
+  }
+  return res;
+}
+
+BigInteger BigInteger::limbs(const BigInteger &a, size_t begin, size_t end) {
+  begin = min(begin, a.num.size());
+  end = min(end, a.num.size());
+  BigInteger res(true,
+                 vector<uint32_t>(a.num.begin() + static_cast<long>(begin),
+                                  a.num.begin() + static_cast<long>(end)));
+  res.DeleteZeros();
+  return res;
+}
+
+void BigInteger::shift_limbs(BigInteger &a, size_t count) {
+  if (a.num.size() > 0) {
+    a.num.insert(a.num.begin(), count, 0);
+  }
+}
+
+void BigInteger::shift_left(BigInteger &a, size_t bits) {
+  int shift = static_cast<int>(bits % 32);
+  a.num = ShiftedLimbs(a.num, shift, a.num.size() + 1);
+  shift_limbs(a, bits / 32);
+  a.DeleteZeros();
+}
+
+void BigInteger::shift_right(BigInteger &a, size_t bits) {
+  a = limbs(a, bits / 32, a.num.size());
+  int shift = static_cast<int>(bits % 32);
+  if (shift != 0) {
+    for (size_t i = 0; i < a.num.size(); ++i) {
+      a.num[i] >>= shift;
+      if (i + 1 < a.num.size()) {
+        a.num[i] |= a.num[i + 1] << (32 - shift);
+      }
     }
-    a.num[i - 1] = digit - 1;
-    curr_num -= (digit - 1) * b;
   }
   a.DeleteZeros();
 }
 
+// Knuth's algorithm D: returns the quotient and leaves the remainder in a.
+BigInteger BigInteger::knuth_div(BigInteger &a, const BigInteger &b) {
+  BigInteger quotient;
+  if (a.num.size() < b.num.size()) {
+    return quotient;
+  }
+  if (b.num.size() == 1) {
+    quotient.num = a.num;
+    a.num.assign(1, DivideSpan(quotient.num.data(), quotient.num.size(),
+                               b.num[0]));
+    a.DeleteZeros();
+    quotient.DeleteZeros();
+    return quotient;
+  }
+  size_t n = b.num.size();
+  size_t m = a.num.size() - n;
+  int shift = CountLeadingZeros(b.num.back());
+  vector<uint32_t> v = ShiftedLimbs(b.num, shift, n);
+  vector<uint32_t> u = ShiftedLimbs(a.num, shift, m + n + 1);
+  uint64_t top = v[n - 1];
+  uint64_t next = v[n - 2];
+  quotient.num.resize(m + 1);
+  for (size_t k = m + 1; k > 0; --k) {
+    uint32_t *window = u.data() + k - 1;
+    uint64_t numerator = static_cast<uint64_t>(window[n]) << 32 | window[n - 1];
+    uint64_t qhat = numerator / top;
+    uint64_t rhat = numerator % top;
+    while (qhat > 0xffffffff || qhat * next > (rhat << 32 | window[n - 2])) {
+      --qhat;
+      rhat += top;
+      if (rhat > 0xffffffff) {
+        break;
+      }
+    }
+    uint64_t transfer = 0;
+    uint32_t borrow = 0;
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t product = qhat * v[i] + transfer;
+      transfer = product >> 32;
+      uint64_t subtrahend = (product & 0xffffffff) + borrow;
+      borrow = window[i] < subtrahend ? 1 : 0;
+      window[i] = static_cast<uint32_t>(window[i] - subtrahend);
+    }
+    uint64_t subtrahend = transfer + borrow;
+    borrow = window[n] < subtrahend ? 1 : 0;
+    window[n] = static_cast<uint32_t>(window[n] - subtrahend);
+    if (borrow != 0) {
+      --qhat;
+      window[n] += AddSpan(window, n, v.data(), n);
+    }
+    quotient.num[k - 1] = static_cast<uint32_t>(qhat);
+  }
+  u.resize(n);
+  a.num.swap(u);
+  shift_right(a, static_cast<size_t>(shift));
+  quotient.DeleteZeros();
+  return quotient;
+}
+
+// Burnikel-Ziegler division of a < b * B^n by b of exactly n limbs with the
+// top bit set: returns the quotient and leaves the remainder in a.
+BigInteger BigInteger::div_2n_1n(BigInteger &a, const BigInteger &b,
+                                 size_t n) {
+  if (n % 2 == 1 || n < burnikel_ziegler_threshold) {
+    return knuth_div(a, b);
+  }
+  size_t half = n / 2;
+  BigInteger remainder = limbs(a, half, a.num.size());
+  BigInteger high = div_3n_2n(remainder, b, half);
+  shift_limbs(remainder, half);
+  remainder += limbs(a, 0, half);
+  BigInteger low = div_3n_2n(remainder, b, half);
+  a = remainder;
+  shift_limbs(high, half);
+  return high + low;
+}
+
+// Divides a < b * B^half by b of 2 * half limbs with the top bit set.
+BigInteger BigInteger::div_3n_2n(BigInteger &a, const BigInteger &b,
+                                 size_t half) {
+  BigInteger b_high = limbs(b, half, 2 * half);
+  BigInteger remainder = limbs(a, half, a.num.size());
+  BigInteger quotient;
+  if (limbs(a, 2 * half, a.num.size()) < b_high) {
+    quotient = div_2n_1n(remainder, b_high, half);
+  } else {
+    quotient.num.assign(half, 0xffffffff);
+    remainder += b_high;
+    shift_limbs(b_high, half);
+    remainder -= b_high;
+  }
+  shift_limbs(remainder, half);
+  remainder += limbs(a, 0, half);
+  remainder -= quotient * limbs(b, 0, half);
+  while (!remainder.is_nonnegative) {
+    --quotient;
+    remainder += b;
+  }
+  a = remainder;
+  return quotient;
+}
+
+// Returns |a| / |b| and leaves |a| % |b| in a. Long divisions are split into
+// blocks of n = j * 2^k limbs, each divided by Burnikel-Ziegler recursion.
+BigInteger BigInteger::div(BigInteger &a, const BigInteger &b) {
+  if (b.num.size() < burnikel_ziegler_threshold ||
+      a.num.size() < b.num.size() + burnikel_ziegler_threshold) {
+    return knuth_div(a, b);
+  }
+  size_t block = b.num.size();
+  size_t levels = 0;
+  while (block >= burnikel_ziegler_threshold) {
+    block = (block + 1) / 2;
+    ++levels;
+  }
+  block <<= levels;
+  size_t shift = 32 * (block - b.num.size()) +
+                 static_cast<size_t>(CountLeadingZeros(b.num.back()));
+  BigInteger divisor = b;
+  shift_left(divisor, shift);
+  shift_left(a, shift);
+  size_t blocks = max(a.num.size() / block + 1, size_t(2));
+  BigInteger remainder = limbs(a, (blocks - 2) * block, blocks * block);
+  BigInteger quotient;
+  quotient.num.resize((blocks - 1) * block);
+  for (size_t i = blocks - 1; i > 0; --i) {
+    BigInteger part = div_2n_1n(remainder, divisor, block);
+    std::copy(part.num.begin(), part.num.end(),
+              quotient.num.begin() + static_cast<long>((i - 1) * block));
+    if (i > 1) {
+      shift_limbs(remainder, block);
+      remainder += limbs(a, (i - 2) * block, (i - 1) * block);
+    }
+  }
+  shift_right(remainder, shift);
+  a = remainder;
+  quotient.DeleteZeros();
+  return quotient;
+}
+
+// The smallest power of two above size + 3: B^WrappedSize(size) - 1
+// determines numbers below B^(size + 3) in magnitude.
+size_t WrappedSize(size_t size) {
+  size_t res = 1;
+  while (res < size + 4) {
+    res <<= 1;
+  }
+  return res;
+}
+
+// floor(B^(2n) / d) for d of n limbs. One Newton step from the reciprocal y
+// of the top t = n / 2 + 3 limbs of d leaves an error of a few units, which
+// is then corrected exactly. Both the Newton residual B^(n + t) - d * y and
+// the final remainder are below B^(n + 3) in magnitude, so they are taken
+// modulo B^WrappedSize(n) - 1.
+BigInteger BigInteger::reciprocal(const BigInteger &d) {
+  size_t n = d.num.size();
+  if (n < newton_threshold) {
+    BigInteger power(true, vector<uint32_t>(2 * n + 1, 0));
+    power.num.back() = 1;
+    return div(power, d);
+  }
+  size_t top = n / 2 + 3;
+  size_t size = WrappedSize(n);
+  BigInteger res = reciprocal(limbs(d, n - top, n));
+  BigInteger power(true, vector<uint32_t>(n + top + 1, 0));
+  power.num.back() = 1;
+  BigInteger residual =
+      wrapped_difference(fold(power, size), mult_wrapped(d, res, size), size);
+  BigInteger step = mult(res, limbs(residual, top - 2, residual.num.size()));
+  step = limbs(step, top + 2, step.num.size());
+  shift_limbs(res, n - top);
+  if (residual.is_nonnegative) {
+    res += step;
+  } else {
+    res -= step;
+  }
+  power.num.assign(2 * n + 1, 0);
+  power.num.back() = 1;
+  BigInteger remainder =
+      wrapped_difference(fold(power, size), mult_wrapped(d, res, size), size);
+  while (!remainder.is_nonnegative) {
+    --res;
+    remainder += d;
+  }
+  while (remainder >= d) {
+    ++res;
+    remainder -= d;
+  }
+  return res;
+}
+
+// Barrett division of 0 <= a < d^2 by d of n limbs: the quotient estimated
+// by multiplying the top of a by the reciprocal is short by at most two, so
+// the remainder is below B^(n + 1) and is taken modulo B^WrappedSize(n) - 1.
+// Returns the quotient and leaves the remainder in a.
+BigInteger BigInteger::barrett_div(BigInteger &a, const BarrettDivisor &d) {
+  size_t n = d.divisor_.num.size();
+  BigInteger top = limbs(a, n - 1, 2 * n);
+  BigInteger quotient = d.transformed_
+                            ? mult_transformed(top, d.reciprocal_transform_)
+                            : top * d.reciprocal_;
+  quotient = limbs(quotient, n + 1, 3 * n + 2);
+  BigInteger product =
+      d.transformed_ ? mult_transformed(quotient, d.divisor_transform_)
+                     : mult_wrapped(quotient, d.divisor_, d.wrapped_size_);
+  a = wrapped_difference(fold(a, d.wrapped_size_), product, d.wrapped_size_);
+  while (a >= d.divisor_) {
+    a -= d.divisor_;
+    ++quotient;
+  }
+  return quotient;
+}
+
+size_t KaratsubaScratchSize(size_t n) {
+  size_t size = 0;
+  while (n > karatsuba_threshold) {
+    n = n - n / 2 + 1;
+    size += 4 * n;
+  }
+  return size;
+}
+
+void SchoolbookMult(const uint32_t *a, const uint32_t *b, size_t n,
+                    uint32_t *res) {
+  std::fill(res, res + 2 * n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    uint64_t transfer = 0;
+    for (size_t j = 0; j < n; ++j) {
+      transfer += static_cast<uint64_t>(a[i]) * b[j] + res[i + j];
+      res[i + j] = static_cast<uint32_t>(transfer);
+      transfer >>= 32;
+    }
+    res[i + n] = static_cast<uint32_t>(transfer);
+  }
+}
+
+// Writes the 2n limbs of a[0, n) * b[0, n) to res. scratch needs
+// KaratsubaScratchSize(n) limbs.
+void KaratsubaMult(const uint32_t *a, const uint32_t *b, size_t n,
+                   uint32_t *res, uint32_t *scratch) {
+  if (n <= karatsuba_threshold) {
+    SchoolbookMult(a, b, n, res);
+    return;
+  }
+  size_t low = n / 2;
+  size_t high = n - low;
+  uint32_t *sum_a = scratch;
+  uint32_t *sum_b = sum_a + high + 1;
+  uint32_t *middle = sum_b + high + 1;
+  std::copy(a + low, a + n, sum_a);
+  std::copy(b + low, b + n, sum_b);
+  sum_a[high] = AddSpan(sum_a, high, a, low);
+  sum_b[high] = AddSpan(sum_b, high, b, low);
+  KaratsubaMult(a, b, low, res, middle);
+  KaratsubaMult(a + low, b + low, high, res + 2 * low, middle);
+  KaratsubaMult(sum_a, sum_b, high + 1, middle, middle + 2 * high + 2);
+  SubtractSpan(middle, 2 * high + 2, res, 2 * low);
+  SubtractSpan(middle, 2 * high + 2, res + 2 * low, 2 * high);
+  AddSpan(res + low, 2 * n - low, middle, 2 * high + 2);
+}
+
+template <uint32_t modulus>
+uint32_t PowMod(uint64_t base, uint64_t exponent) {
+  uint64_t res = 1;
+  base %= modulus;
+  while (exponent != 0) {
+    if (exponent & 1) {
+      res = res * base % modulus;
+    }
+    base = base * base % modulus;
+    exponent >>= 1;
+  }
+  return static_cast<uint32_t>(res);
+}
+
+// a * w modulo modulus, lazily reduced to [0, 2 * modulus).
+template <uint32_t modulus>
+uint32_t MulModShoup(uint32_t a, uint32_t w, uint32_t w_shoup) {
+  uint32_t quotient =
+      static_cast<uint32_t>(static_cast<uint64_t>(a) * w_shoup >> 32);
+  return a * w - quotient * modulus;
+}
+
+// roots_[length + j] is the j-th power of the primitive 2 * length-th root of
+// unity, for every power of two length below n; shoup_roots_ holds
+// floor(root * 2^32 / modulus) for multiplying by it without a division.
+template <uint32_t modulus>
+struct NttRoots {
+  vector<uint32_t> roots_;
+  vector<uint32_t> shoup_roots_;
+
+  explicit NttRoots(size_t n) : roots_(max(n, size_t(2))) {
+    for (size_t length = 1; length < n; length <<= 1) {
+      uint64_t step =
+          PowMod<modulus>(ntt_generator, (modulus - 1) / (2 * length));
+      roots_[length] = 1;
+      for (size_t j = 1; j < length; ++j) {
+        roots_[length + j] =
+            static_cast<uint32_t>(roots_[length + j - 1] * step % modulus);
+      }
+    }
+    shoup_roots_.resize(roots_.size());
+    for (size_t i = 0; i < roots_.size(); ++i) {
+      shoup_roots_[i] = static_cast<uint32_t>(
+          (static_cast<uint64_t>(roots_[i]) << 32) / modulus);
+    }
+  }
+};
+
+// Decimation in frequency of a[0, n): leaves the transform in bit-reversed
+// order. Halves larger than ntt_block_size are finished one at a time so
+// that all but the top levels run in cache. Values stay in
+// [0, 2 * modulus) between levels.
+template <uint32_t modulus>
+void ForwardNtt(uint32_t *a, size_t n, const NttRoots<modulus> &roots) {
+  const uint32_t twice_modulus = 2 * modulus;
+  size_t top = n > ntt_block_size ? n / 2 : 0;
+  for (size_t length = n / 2; length > 0; length >>= 1) {
+    if (length < top) {
+      ForwardNtt(a, top, roots);
+      ForwardNtt(a + top, top, roots);
+      return;
+    }
+    for (size_t i = 0; i < n; i += 2 * length) {
+      for (size_t j = 0; j < length; ++j) {
+        uint32_t u = a[i + j];
+        uint32_t v = a[i + j + length];
+        uint32_t sum = u + v;
+        a[i + j] = sum >= twice_modulus ? sum - twice_modulus : sum;
+        a[i + j + length] = MulModShoup<modulus>(
+            u + twice_modulus - v, roots.roots_[length + j],
+            roots.shoup_roots_[length + j]);
+      }
+    }
+  }
+}
+
+// Decimation in time of a[0, n) from bit-reversed order, with the forward
+// roots; the caller turns the result into the inverse transform. Values stay
+// in [0, 4 * modulus) between levels.
+template <uint32_t modulus>
+void BackwardNtt(uint32_t *a, size_t n, const NttRoots<modulus> &roots) {
+  const uint32_t twice_modulus = 2 * modulus;
+  size_t length = 1;
+  if (n > ntt_block_size) {
+    length = n / 2;
+    BackwardNtt(a, length, roots);
+    BackwardNtt(a + length, length, roots);
+  }
+  for (; length < n; length <<= 1) {
+    for (size_t i = 0; i < n; i += 2 * length) {
+      for (size_t j = 0; j < length; ++j) {
+        uint32_t u = a[i + j];
+        u = u >= twice_modulus ? u - twice_modulus : u;
+        uint32_t v =
+            MulModShoup<modulus>(a[i + j + length], roots.roots_[length + j],
+                                 roots.shoup_roots_[length + j]);
+        a[i + j] = u + v;
+        a[i + j + length] = u + twice_modulus - v;
+      }
+    }
+  }
+}
+
+template <uint32_t modulus>
+const NttRoots<modulus> &CachedNttRoots(size_t n) {
+  static NttRoots<modulus> roots(2);
+  if (roots.roots_.size() < n) {
+    roots = NttRoots<modulus>(n);
+  }
+  return roots;
+}
+
+// Forward transform of length n of a modulo the prime modulus.
+template <uint32_t modulus>
+vector<uint32_t> NttTransform(const uint32_t *a, size_t a_size, size_t n) {
+  vector<uint32_t> res(n);
+  for (size_t i = 0; i < a_size; ++i) {
+    res[i] = a[i] % modulus;
+  }
+  ForwardNtt<modulus>(res.data(), n, CachedNttRoots<modulus>(n));
+  return res;
+}
+
+// Turns the transform fa into the cyclic convolution of its number with the
+// one transformed to fb, modulo the prime modulus.
+template <uint32_t modulus>
+void NttConvolution(vector<uint32_t> &fa, const vector<uint32_t> &fb) {
+  size_t n = fa.size();
+  uint64_t inverse_n = PowMod<modulus>(n, modulus - 2);
+  for (size_t i = 0; i < n; ++i) {
+    fa[i] = static_cast<uint32_t>(static_cast<uint64_t>(fa[i]) * fb[i] %
+                                  modulus * inverse_n % modulus);
+  }
+  BackwardNtt<modulus>(fa.data(), n, CachedNttRoots<modulus>(n));
+  for (uint32_t &x : fa) {
+    x %= modulus;
+  }
+  std::reverse(fa.begin() + 1, fa.end());
+}
+
+NttFactor::NttFactor(const uint32_t *a, size_t a_size, size_t n)
+    : size_(a_size),
+      transform1_(NttTransform<ntt_modulus1>(a, a_size, n)),
+      transform2_(NttTransform<ntt_modulus2>(a, a_size, n)),
+      transform3_(NttTransform<ntt_modulus3>(a, a_size, n)) {}
+
+// Writes the cyclic convolution of the numbers transformed to a and b to
+// res[0, n), consuming a. A coefficient sums at most min(a.size_, b.size_)
+// products of two limbs, so it stays below the product of the three primes,
+// about 2^86.02, only while the shorter factor has at most
+// max_ntt_factor = 2^22 limbs; callers assert that. The three convolutions
+// are joined by Garner's CRT while carrying into limbs. Returns the carry out
+// of the top limb.
+uint64_t NttCyclicMult(NttFactor a, const NttFactor &b, uint32_t *res) {
+  vector<uint32_t> &r1 = a.transform1_;
+  vector<uint32_t> &r2 = a.transform2_;
+  vector<uint32_t> &r3 = a.transform3_;
+  NttConvolution<ntt_modulus1>(r1, b.transform1_);
+  NttConvolution<ntt_modulus2>(r2, b.transform2_);
+  NttConvolution<ntt_modulus3>(r3, b.transform3_);
+  uint64_t inverse12 = PowMod<ntt_modulus2>(ntt_modulus1, ntt_modulus2 - 2);
+  uint64_t inverse13 = PowMod<ntt_modulus3>(ntt_modulus1, ntt_modulus3 - 2);
+  uint64_t inverse23 = PowMod<ntt_modulus3>(ntt_modulus2, ntt_modulus3 - 2);
+  uint64_t modulus12 = static_cast<uint64_t>(ntt_modulus1) * ntt_modulus2;
+  uint64_t transfer = 0;
+  for (size_t i = 0; i < r1.size(); ++i) {
+    uint64_t x1 = r1[i];
+    uint64_t k2 = (r2[i] + ntt_modulus2 - x1 % ntt_modulus2) * inverse12 %
+                  ntt_modulus2;
+    uint64_t k3 = (r3[i] + ntt_modulus3 - x1 % ntt_modulus3) * inverse13 %
+                  ntt_modulus3;
+    k3 = (k3 + ntt_modulus3 - k2 % ntt_modulus3) * inverse23 % ntt_modulus3;
+    uint64_t low =
+        x1 + ntt_modulus1 * k2 + (modulus12 & 0xffffffff) * k3 + transfer;
+    res[i] = static_cast<uint32_t>(low);
+    transfer = (low >> 32) + (modulus12 >> 32) * k3;
+  }
+  return transfer;
+}
+
+// The product of a and b for a_size + b_size up to max_ntt_size and the
+// shorter of them up to max_ntt_factor limbs, from a cyclic convolution long
+// enough not to wrap.
+vector<uint32_t> NttMult(const uint32_t *a, size_t a_size, const uint32_t *b,
+                         size_t b_size) {
+  assert(a_size + b_size <= max_ntt_size);
+  assert(min(a_size, b_size) <= max_ntt_factor);
+  size_t n = 1;
+  while (n < a_size + b_size) {
+    n <<= 1;
+  }
+  vector<uint32_t> res(n);
+  NttFactor fa(a, a_size, n);
+  if (a == b && a_size == b_size) {
+    NttCyclicMult(fa, fa, res.data());
+  } else {
+    NttCyclicMult(std::move(fa), NttFactor(b, b_size, n), res.data());
+  }
+  res.resize(a_size + b_size);
+  return res;
+}
+
 BigInteger BigInteger::mult(const BigInteger &a, const BigInteger &b) {
   if (a.num.size() == 0 || b.num.size() == 0) {
     return BigInteger();
   }
-  if (a.num.size() == 1) {
-    return linear_mult(b, a.num[0]);
-  } else if (b.num.size() == 1) {
-    return linear_mult(a, b.num[0]);
-  } else {
-    size_t m = min(a.num.size(), b.num.size()) / 2;
-    BigInteger high_a(true, vector<int>(a.num.begin(), a.num.begin() + m));
-    BigInteger high_b(true, vector<int>(b.num.begin(), b.num.begin() + m));
-    BigInteger low_a(true, vector<int>(a.num.begin() + m, a.num.end()));
-    BigInteger low_b(true, vector<int>(b.num.begin() + m, b.num.end()));
-    BigInteger z2 = mult(low_a, low_b);
-    BigInteger z1 = mult((low_a + high_a), (low_b + high_b));
-    BigInteger z0 = mult(high_a, high_b);
-    BigInteger dif_of_parts = z1 - z2 - z0;
-    pow_10(z2, m * 2);
-    pow_10(dif_of_parts, m);
-    return z2 + dif_of_parts + z0;
-  }
-}
-
-BigInteger BigInteger::linear_mult(const BigInteger &a, int m) {
+  const vector<uint32_t> &longer =
+      a.num.size() >= b.num.size() ? a.num : b.num;
+  const vector<uint32_t> &shorter =
+      a.num.size() >= b.num.size() ? b.num : a.num;
+  size_t n = shorter.size();
   BigInteger res;
-  int transfer = 0;
-  for (size_t i = 0; i < a.num.size(); ++i) {
-    transfer = a.num[i] * m + transfer;
-    res.num.push_back(transfer % 10);
-    transfer /= 10;
+  res.num.resize(longer.size() + n);
+  if (n >= ntt_threshold) {
+    // Equal blocks of the shorter factor keep within max_ntt_factor limbs
+    // and chunks of the longer one fill the rest of a max_ntt_size transform.
+    size_t blocks = (n + max_ntt_factor - 1) / max_ntt_factor;
+    size_t block = (n + blocks - 1) / blocks;
+    size_t step = max_ntt_size - block;
+    for (size_t low = 0; low < n; low += block) {
+      size_t block_size = min(block, n - low);
+      for (size_t start = 0; start < longer.size(); start += step) {
+        size_t size = min(step, longer.size() - start);
+        vector<uint32_t> product = NttMult(longer.data() + start, size,
+                                           shorter.data() + low, block_size);
+        AddSpan(res.num.data() + low + start,
+                res.num.size() - low - start, product.data(),
+                product.size());
+      }
+    }
+    res.DeleteZeros();
+    return res;
   }
-  if (transfer != 0) {
-    res.num.push_back(transfer);
+  vector<uint32_t> chunk(n);
+  vector<uint32_t> product(2 * n);
+  vector<uint32_t> scratch(KaratsubaScratchSize(n));
+  for (size_t start = 0; start < longer.size(); start += n) {
+    size_t size = min(n, longer.size() - start);
+    std::copy(longer.begin() + static_cast<std::ptrdiff_t>(start),
+              longer.begin() + static_cast<std::ptrdiff_t>(start + size),
+              chunk.begin());
+    std::fill(chunk.begin() + static_cast<std::ptrdiff_t>(size), chunk.end(),
+              0);
+    KaratsubaMult(chunk.data(), shorter.data(), n, product.data(),
+                  scratch.data());
+    AddSpan(res.num.data() + start, res.num.size() - start, product.data(),
+            size + n);
+  }
+  res.DeleteZeros();
+  return res;
+}
+
+// |a| modulo B^size - 1, as a representative in [0, B^size - 1].
+BigInteger BigInteger::fold(const BigInteger &a, size_t size) {
+  BigInteger res(true, vector<uint32_t>(size, 0));
+  for (size_t start = 0; start < a.num.size(); start += size) {
+    uint32_t transfer =
+        AddSpan(res.num.data(), size, a.num.data() + start,
+                min(size, a.num.size() - start));
+    while (transfer != 0) {
+      transfer = AddSpan(res.num.data(), size, &transfer, 1);
+    }
+  }
+  res.DeleteZeros();
+  return res;
+}
+
+// |a| * |b| modulo B^size - 1 for a power of two size, as a representative in
+// [0, B^size - 1]. Long factors of at most size limbs, the shorter within
+// max_ntt_factor, take one cyclic convolution of length size, half of what
+// their full product needs.
+BigInteger BigInteger::mult_wrapped(const BigInteger &a, const BigInteger &b,
+                                    size_t size) {
+  size_t shorter = min(a.num.size(), b.num.size());
+  if (shorter < ntt_threshold || shorter > max_ntt_factor ||
+      max(a.num.size(), b.num.size()) > size || size > max_ntt_size) {
+    return fold(mult(a, b), size);
+  }
+  return mult_transformed(a, NttFactor(b.num.data(), b.num.size(), size));
+}
+
+// |a| times the number transformed to b modulo B^n - 1, for a of at most n
+// limbs, n the length of the transform and the shorter factor of at most
+// max_ntt_factor limbs.
+BigInteger BigInteger::mult_transformed(const BigInteger &a,
+                                        const NttFactor &b) {
+  size_t n = b.transform1_.size();
+  assert(a.num.size() <= n);
+  assert(min(a.num.size(), b.size_) <= max_ntt_factor);
+  BigInteger res(true, vector<uint32_t>(n));
+  uint64_t transfer = NttCyclicMult(NttFactor(a.num.data(), a.num.size(), n),
+                                    b, res.num.data());
+  uint32_t wrapped[2] = {static_cast<uint32_t>(transfer),
+                         static_cast<uint32_t>(transfer >> 32)};
+  uint32_t carry = AddSpan(res.num.data(), n, wrapped, 2);
+  while (carry != 0) {
+    carry = AddSpan(res.num.data(), n, &carry, 1);
+  }
+  res.DeleteZeros();
+  return res;
+}
+
+// The x = a - b modulo B^size - 1 of least magnitude, for a and b reduced
+// modulo it: the exact difference when that is known to be below
+// B^size / 2 in magnitude.
+BigInteger BigInteger::wrapped_difference(const BigInteger &a,
+                                          const BigInteger &b, size_t size) {
+  BigInteger res = a - b;
+  if (res.num.size() == size && res.num.back() >= 0x80000000) {
+    BigInteger modulus(true, vector<uint32_t>(size, 0xffffffff));
+    if (res.is_nonnegative) {
+      res -= modulus;
+    } else {
+      res += modulus;
+    }
   }
   return res;
 }
 
-void BigInteger::pow_10(BigInteger &a, int pow) {
-  a.num.insert(a.num.begin(), pow, 0);
+BigInteger::BarrettDivisor::BarrettDivisor(const BigInteger &divisor)
+    : divisor_(divisor),
+      reciprocal_(reciprocal(divisor)),
+      wrapped_size_(WrappedSize(divisor.num.size())),
+      transformed_(false) {
+  size_t n = divisor.num.size();
+  size_t size = 1;
+  while (size < 2 * n + 2) {
+    size <<= 1;
+  }
+  if (n >= ntt_threshold && size <= max_ntt_size) {
+    transformed_ = true;
+    reciprocal_transform_ =
+        NttFactor(reciprocal_.num.data(), reciprocal_.num.size(), size);
+    divisor_transform_ = NttFactor(divisor.num.data(), n, wrapped_size_);
+  }
 }
 
 BigInteger &BigInteger::operator*=(const BigInteger &b) {
@@ -363,20 +1152,29 @@ BigInteger &BigInteger::operator*=(const BigInteger &b) {
   *this = abs(*this);
   *this = mult(*this, abs(b));
   this->is_nonnegative = sign;
+  this->DeleteZeros();
   return *this;
 }
 
+std::pair<BigInteger, BigInteger> divmod(const BigInteger &a,
+                                         const BigInteger &b) {
+  BigInteger remainder = a;
+  remainder.is_nonnegative = true;
+  BigInteger quotient = BigInteger::div(remainder, BigInteger::abs(b));
+  quotient.is_nonnegative = a.is_nonnegative == b.is_nonnegative;
+  remainder.is_nonnegative = a.is_nonnegative;
+  quotient.DeleteZeros();
+  remainder.DeleteZeros();
+  return {quotient, remainder};
+}
+
 BigInteger &BigInteger::operator/=(const BigInteger &b) {
-  bool sign = (this->is_nonnegative && b.is_nonnegative) ||
-              (!this->is_nonnegative && !b.is_nonnegative);
-  *this = abs(*this);
-  div(*this, abs(b));
-  this->is_nonnegative = sign;
+  *this = divmod(*this, b).first;
   return *this;
 }
 
 BigInteger &BigInteger::operator%=(const BigInteger &b) {
-  *this = *this - *this / b * b;
+  *this = divmod(*this, b).second;
   return *this;
 }
 
@@ -398,3 +1196,37 @@ BigInteger operator%(const BigInteger &a, const BigInteger &b) {
   return res;
 }
 
+#ifdef BIGINTEGER_SELF_TEST
+#include <sstream>
+
+// Squares B^limbs - 1 modulo B^size - 1 by mult_wrapped and by folding the
+// full product. With every limb all ones, every convolution coefficient is
+// as large as it gets.
+bool CheckWrappedSquare(size_t limbs, size_t size) {
+  BigInteger a(true, vector<uint32_t>(limbs, 0xffffffff));
+  return BigInteger::mult_wrapped(a, a, size) ==
+         BigInteger::fold(BigInteger::mult(a, a), size);
+}
+
+int main() {
+  int failures = 0;
+  for (size_t limbs : {size_t(4000000), max_ntt_factor, max_ntt_factor + 1,
+                       size_t(6291456)}) {
+    if (!CheckWrappedSquare(limbs, max_ntt_size)) {
+      std::cerr << "mult_wrapped of " << limbs << " limbs squared is wrong\n";
+      ++failures;
+    }
+  }
+  BigInteger power = 7;
+  for (int i = 0; i < 18; ++i) {
+    power *= power;
+  }
+  BigInteger copy;
+  std::istringstream(power.toString()) >> copy;
+  if (copy != power) {
+    std::cerr << "decimal round trip is wrong\n";
+    ++failures;
+  }
+  return failures == 0 ? 0 : 1;
+}
+#endif